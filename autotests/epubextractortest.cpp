@@ -0,0 +1,116 @@
+/*
+    Tests for the EPub extractor
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "epubextractortest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "simpleresult.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/epubextractor.h"
+
+using namespace KFileMetaData;
+
+QString EPubExtractorTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void EPubExtractorTest::testText_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("parallelism");
+
+    QTest::newRow("navigation map") << QString::fromLatin1("test.epub") << 1;
+    QTest::newRow("navigation map, parallel") << QString::fromLatin1("test.epub") << 2;
+    QTest::newRow("guide") << QString::fromLatin1("test_guide.epub") << 1;
+}
+
+void EPubExtractorTest::testText()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, parallelism);
+
+    EPubExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath(fileName), "application/epub+zip");
+    result.setParallelism(parallelism);
+    plugin.extract(&result);
+
+    // The package document is in OEBPS/, and the spine lists the first chapter
+    // several times. The appendix is only linked from the navigation map, or
+    // from the guide of the book which has no navigation map. The <title> of the
+    // second chapter is not part of the text.
+    QString content;
+    QTextStream(&content) << "Chapter One\nFirst chapter. "
+                          << "Chapter Two\nSecond & last chapter. "
+                          << "Appendix\nOnly linked from the table of contents. ";
+
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Document);
+
+    QCOMPARE(result.text(), content);
+    QVERIFY(!result.text().contains(QLatin1String("Book Title")));
+}
+
+void EPubExtractorTest::testTextBudget_data()
+{
+    QTest::addColumn<int>("parallelism");
+
+    QTest::newRow("sequential") << 1;
+    QTest::newRow("parallel") << 2;
+}
+
+void EPubExtractorTest::testTextBudget()
+{
+    QFETCH(int, parallelism);
+
+    EPubExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.epub"), "application/epub+zip");
+    result.setParallelism(parallelism);
+    result.setTextBudget(10);
+    plugin.extract(&result);
+
+    // The first chapter uses up the budget, no further chapters are read
+    QCOMPARE(result.text(), QString("Chapter One\nFirst chapter. "));
+}
+
+void EPubExtractorTest::testMetaData()
+{
+    EPubExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.epub"), "application/epub+zip", ExtractionResult::ExtractMetaData);
+    plugin.extract(&result);
+
+    QVERIFY(result.text().isEmpty());
+
+    // Only the first title, the author without the illustrator and the publication date
+    const PropertyMap properties = result.properties();
+    QCOMPARE(properties.value(Property::Title), QVariant(QLatin1String("Book Title")));
+    QCOMPARE(properties.value(Property::Creator), QVariant(QLatin1String("Jane Author")));
+    QCOMPARE(properties.value(Property::Subject), QVariant(QLatin1String("Fiction")));
+    QCOMPARE(properties.value(Property::Publisher), QVariant(QLatin1String("Publisher")));
+    QCOMPARE(properties.value(Property::Description), QVariant(QLatin1String("A short book.")));
+    QCOMPARE(properties.value(Property::CreationDate).toDateTime(), QDateTime(QDate(2015, 3, 1), QTime(0, 0), Qt::UTC));
+    QCOMPARE(properties.size(), 6);
+}
+
+QTEST_KDEMAIN_CORE(EPubExtractorTest)
@@ -55,9 +55,8 @@ void IndexerExtractorTests::benchMarkPlainTextExtractor()
         file.write("\n");
     }
 
-    SimpleResult result(file.fileName(), "text/plain");
-
     QBENCHMARK {
+        SimpleResult result(file.fileName(), "text/plain");
         plugin.extract(&result);
     }
 }
@@ -85,5 +84,55 @@ void IndexerExtractorTests::testPlainTextExtractor()
     QCOMPARE(result.text(), content);
 }
 
+void IndexerExtractorTests::testPlainTextExtractorAppend()
+{
+    PlainTextExtractor plugin(this, QVariantList());
+
+    QTemporaryFile file("XXXXXX.txt");
+    QVERIFY(file.open());
+    file.write("first line\nsecond line\nunfinished");
+    file.flush();
+
+    // The state is only computed when asked for
+    SimpleResult plainResult(file.fileName(), "text/plain");
+    plugin.extract(&plainResult);
+    QVERIFY(!plainResult.hasAppendState());
+
+    SimpleResult result(file.fileName(), "text/plain",
+                        ExtractionResult::ExtractEverything | ExtractionResult::ExtractAppendState);
+    plugin.extract(&result);
+
+    QCOMPARE(result.properties().value(Property::LineCount), QVariant(3));
+    QVERIFY(result.hasAppendState());
+    QCOMPARE(result.appendStateSize(), qint64(23));
+    QCOMPARE(result.appendStateLineCount(), 2);
+
+    file.write(" line\nfourth line\n");
+    file.flush();
+
+    SimpleResult appendResult(file.fileName(), "text/plain");
+    appendResult.setAppendState(result.appendStateSize(), result.appendStateLineCount(),
+                                result.appendStateTailHash());
+    plugin.extract(&appendResult);
+
+    QCOMPARE(appendResult.text(), QString("unfinished line fourth line "));
+    QCOMPARE(appendResult.properties().value(Property::LineCount), QVariant(4));
+    QCOMPARE(appendResult.appendStateSize(), file.size());
+    QCOMPARE(appendResult.appendStateLineCount(), 4);
+
+    // Modifying the already processed data results in a full extraction
+    QVERIFY(file.seek(0));
+    file.write("FIRST");
+    file.flush();
+
+    SimpleResult modifiedResult(file.fileName(), "text/plain");
+    modifiedResult.setAppendState(appendResult.appendStateSize(), appendResult.appendStateLineCount(),
+                                  appendResult.appendStateTailHash());
+    plugin.extract(&modifiedResult);
+
+    QCOMPARE(modifiedResult.text(), QString("FIRST line second line unfinished line fourth line "));
+    QCOMPARE(modifiedResult.properties().value(Property::LineCount), QVariant(4));
+}
+
 QTEST_KDEMAIN_CORE(IndexerExtractorTests)
 
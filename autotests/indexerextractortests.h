@@ -37,6 +37,7 @@ private:
 private slots:
     void benchMarkPlainTextExtractor();
     void testPlainTextExtractor();
+    void testPlainTextExtractorAppend();
 };
 
 #endif // INDEXERTESTS_H
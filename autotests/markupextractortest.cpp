@@ -0,0 +1,57 @@
+/*
+    Tests for the HTML and XML markup extractor
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "markupextractortest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "simpleresult.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/markupextractor.h"
+
+using namespace KFileMetaData;
+
+QString MarkupExtractorTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void MarkupExtractorTest::test()
+{
+    QScopedPointer<ExtractorPlugin> plugin(new MarkupExtractor(this, QVariantList()));
+
+    SimpleResult result(testFilePath("test.html"), "text/html");
+    plugin->extract(&result);
+
+    QString content;
+    QTextStream(&content) << "Sample & Test\n"
+                          << "Heading\n"
+                          << QString::fromUtf8("Some boldly formatted <text> with caf\xc3\xa9 and \xe2\x80\x94 dashes.\n")
+                          << "Second paragraph, softly hyphenated ";
+
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Text);
+
+    QCOMPARE(result.properties().size(), 1);
+    QCOMPARE(result.properties().value(Property::Title), QVariant(QLatin1String("Sample & Test")));
+
+    QCOMPARE(result.text(), content);
+}
+
+QTEST_KDEMAIN_CORE(MarkupExtractorTest)
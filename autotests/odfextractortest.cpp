@@ -0,0 +1,137 @@
+/*
+    Tests for the OpenDocument extractor
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "odfextractortest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "simpleresult.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/odfextractor.h"
+
+using namespace KFileMetaData;
+
+QString OdfExtractorTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void OdfExtractorTest::testText()
+{
+    OdfExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.odt"), "application/vnd.oasis.opendocument.text");
+    plugin.extract(&result);
+
+    // The forms, the tracked deletion, the note citation and the styles are skipped.
+    // Paragraphs in lists, tables and notes are separated like the others.
+    QString content;
+    QTextStream(&content) << "Heading\n"
+                          << "Spaced out\ttabbed\n"
+                          << "next line\n"
+                          << "List item\n"
+                          << "Cell one\n"
+                          << "Cell two\n"
+                          << "Main text\n"
+                          << "Note text\n"
+                          << " continues & ends ";
+
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Document);
+
+    QCOMPARE(result.text(), content);
+}
+
+void OdfExtractorTest::testMetaDataOnly()
+{
+    OdfExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.odt"), "application/vnd.oasis.opendocument.text",
+                        ExtractionResult::ExtractMetaData);
+    plugin.extract(&result);
+
+    QVERIFY(result.text().isEmpty());
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.properties().value(Property::Title), QVariant(QLatin1String("ODF Title")));
+}
+
+void OdfExtractorTest::testMetaData()
+{
+    OdfExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.odt"), "application/vnd.oasis.opendocument.text");
+    plugin.extract(&result);
+
+    const PropertyMap properties = result.properties();
+    QCOMPARE(properties.value(Property::Title), QVariant(QLatin1String("ODF Title")));
+    QCOMPARE(properties.value(Property::Subject), QVariant(QLatin1String("ODF Subject")));
+    QCOMPARE(properties.value(Property::Description), QVariant(QLatin1String("ODF Description")));
+    QCOMPARE(properties.value(Property::Langauge), QVariant(QLatin1String("fr-FR")));
+    QCOMPARE(properties.value(Property::PageCount), QVariant(2));
+    QCOMPARE(properties.value(Property::WordCount), QVariant(27));
+
+    // The creation date has no time zone
+    QCOMPARE(properties.value(Property::CreationDate).toDateTime(),
+             QDateTime(QDate(2015, 3, 1), QTime(10, 20, 30)));
+
+    // The generator is added as a creator as well, the last one added comes first
+    QCOMPARE(properties.values(Property::Creator),
+             QList<QVariant>() << QString::fromUtf8("Zo\xc3\xab Writer") << QLatin1String("LibreOffice/4.4.0.3$Linux_X86_64"));
+    QCOMPARE(properties.values(Property::Keywords),
+             QList<QVariant>() << QLatin1String("beta") << QLatin1String("alpha"));
+
+    QCOMPARE(properties.size(), 11);
+}
+
+void OdfExtractorTest::testFlatDocument()
+{
+    OdfExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.fodt"), "application/vnd.oasis.opendocument.text-flat-xml");
+    plugin.extract(&result);
+
+    // The same document as test.odt, with the metadata, the styles and the body in one file,
+    // and an image which is embedded in the list item
+    QString content;
+    QTextStream(&content) << "Heading\n"
+                          << "Spaced out\ttabbed\n"
+                          << "next line\n"
+                          << "List item\n"
+                          << "Cell one\n"
+                          << "Cell two\n"
+                          << "Main text\n"
+                          << "Note text\n"
+                          << " continues & ends ";
+
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Document);
+
+    QCOMPARE(result.text(), content);
+    QVERIFY(!result.text().contains(QLatin1String("iVBORw0KGgo")));
+
+    const PropertyMap properties = result.properties();
+    QCOMPARE(properties.value(Property::Title), QVariant(QLatin1String("ODF Title")));
+    QCOMPARE(properties.value(Property::WordCount), QVariant(27));
+    QCOMPARE(properties.values(Property::Keywords),
+             QList<QVariant>() << QLatin1String("beta") << QLatin1String("alpha"));
+    QCOMPARE(properties.size(), 11);
+}
+
+QTEST_KDEMAIN_CORE(OdfExtractorTest)
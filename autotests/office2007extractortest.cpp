@@ -0,0 +1,153 @@
+/*
+    Tests for the Office Open XML extractor
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "office2007extractortest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "simpleresult.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/office2007extractor.h"
+
+using namespace KFileMetaData;
+
+QString Office2007ExtractorTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void Office2007ExtractorTest::testSpreadsheet()
+{
+    Office2007Extractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.xlsx"), "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet");
+    plugin.extract(&result);
+
+    // The shared strings come first, without their phonetic hints, followed by the
+    // inline strings of each sheet. Numbers, formulas and styles are not text.
+    QString content;
+    QTextStream(&content) << "Alpha\n"
+                          << "Rich text\n"
+                          << QString::fromUtf8("\xe6\xbc\xa2\xe5\xad\x97 ")
+                          << "Inline cell "
+                          << "Second sheet ";
+
+    QCOMPARE(result.types().size(), 2);
+    QCOMPARE(result.types().at(0), Type::Document);
+    QCOMPARE(result.types().at(1), Type::Spreadsheet);
+
+    QCOMPARE(result.text(), content);
+    QCOMPARE(result.properties().value(Property::SheetCount), QVariant(2));
+    QCOMPARE(result.properties().value(Property::Title), QVariant(QLatin1String("Workbook Title")));
+}
+
+void Office2007ExtractorTest::testPresentation()
+{
+    Office2007Extractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.pptx"), "application/vnd.openxmlformats-officedocument.presentationml.presentation");
+    plugin.extract(&result);
+
+    // The deck lists slide2.xml before slide1.xml. The notes follow their slide, the
+    // slide number field and the text of the master and the layout are skipped.
+    QString content;
+    QTextStream(&content) << "First slide title\n"
+                          << "Body of the first slide "
+                          << "Speaker notes "
+                          << "Second slide ";
+
+    QCOMPARE(result.types().size(), 2);
+    QCOMPARE(result.types().at(0), Type::Document);
+    QCOMPARE(result.types().at(1), Type::Presentation);
+
+    QCOMPARE(result.text(), content);
+    QCOMPARE(result.properties().value(Property::SlideCount), QVariant(2));
+}
+
+void Office2007ExtractorTest::testDocument_data()
+{
+    QTest::addColumn<int>("parallelism");
+
+    QTest::newRow("sequential") << 1;
+    QTest::newRow("parallel") << 4;
+}
+
+void Office2007ExtractorTest::testDocument()
+{
+    QFETCH(int, parallelism);
+
+    Office2007Extractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.docx"), "application/vnd.openxmlformats-officedocument.wordprocessingml.document");
+    result.setParallelism(parallelism);
+    plugin.extract(&result);
+
+    // The runs of a paragraph are joined. Deleted text, field instructions and the
+    // tab stops of the paragraph properties are skipped. The body is followed by
+    // the headers, the footers and the footnotes.
+    QString content;
+    QTextStream(&content) << "Hello world\n"
+                          << "Before\ttab\n"
+                          << "after break\n"
+                          << "a link\n"
+                          << QString::fromUtf8("Caf\xc3\xa9 & more ")
+                          << "Header text "
+                          << "Footer text "
+                          << "A footnote ";
+
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Document);
+
+    QCOMPARE(result.text(), content);
+}
+
+void Office2007ExtractorTest::testMetaData()
+{
+    Office2007Extractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.docx"), "application/vnd.openxmlformats-officedocument.wordprocessingml.document",
+                        ExtractionResult::ExtractMetaData);
+    plugin.extract(&result);
+
+    QVERIFY(result.text().isEmpty());
+
+    // docProps/core.xml
+    const PropertyMap properties = result.properties();
+    QCOMPARE(properties.value(Property::Title), QVariant(QLatin1String("Document Title")));
+    QCOMPARE(properties.value(Property::Subject), QVariant(QLatin1String("Document Subject")));
+    QCOMPARE(properties.value(Property::Description), QVariant(QLatin1String("Document Description")));
+    QCOMPARE(properties.value(Property::Creator), QVariant(QString::fromUtf8("J\xc3\xbcrgen Author")));
+    QCOMPARE(properties.value(Property::Langauge), QVariant(QLatin1String("de-DE")));
+    QCOMPARE(properties.value(Property::CreationDate).toDateTime(),
+             QDateTime(QDate(2015, 3, 1), QTime(10, 20, 30), Qt::UTC));
+
+    // The keywords are split, the last one added comes first
+    QCOMPARE(properties.values(Property::Keywords),
+             QList<QVariant>() << QLatin1String("third") << QLatin1String("second") << QLatin1String("first"));
+
+    // docProps/app.xml
+    QCOMPARE(properties.value(Property::Generator), QVariant(QLatin1String("Microsoft Office Word")));
+    QCOMPARE(properties.value(Property::PageCount), QVariant(3));
+    QCOMPARE(properties.value(Property::WordCount), QVariant(120));
+
+    QCOMPARE(properties.size(), 12);
+}
+
+QTEST_KDEMAIN_CORE(Office2007ExtractorTest)
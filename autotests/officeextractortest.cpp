@@ -0,0 +1,164 @@
+/*
+    Tests for the Word, Excel and PowerPoint 97-2003 extractor
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "officeextractortest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "simpleresult.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/officeextractor.h"
+#include "extractors/cfbreader.h"
+
+using namespace KFileMetaData;
+
+QString OfficeExtractorTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void OfficeExtractorTest::testWordDocument()
+{
+    OfficeExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.doc"), "application/msword");
+    plugin.extract(&result);
+
+    // The second piece of the document is stored as UTF-16, the others as cp1252.
+    // Field instructions are dropped, only the field result is kept.
+    QString content;
+    QTextStream(&content) << "Hello world\n"
+                          << QString::fromUtf8("This is a test \xe2\x80\x94 with a link and \xce\xb1\xce\xb2\xce\xb3\n")
+                          << QString::fromUtf8("Caf\xc3\xa9 \xe2\x80\x9cquoted\xe2\x80\x9d ");
+
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Document);
+
+    QCOMPARE(result.text(), content);
+    QCOMPARE(result.properties().value(Property::WordCount), QVariant(14));
+    QCOMPARE(result.properties().value(Property::LineCount), QVariant(3));
+}
+
+void OfficeExtractorTest::testCorruptSectorChain()
+{
+    // The sector chain of the WordDocument stream loops back to its start
+    CfbReader reader(testFilePath("test_corrupt_chain.doc"));
+    QVERIFY(reader.isValid());
+    QVERIFY(reader.stream(QLatin1String("1Table")).isValid());
+    QVERIFY(!reader.stream(QLatin1String("WordDocument")).isValid());
+
+    OfficeExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test_corrupt_chain.doc"), "application/msword");
+    plugin.extract(&result);
+
+    // Not being able to read the text must not prevent the rest of the extraction
+    QCOMPARE(result.types().size(), 1);
+    QCOMPARE(result.types().first(), Type::Document);
+}
+
+void OfficeExtractorTest::testExcelDocument()
+{
+    OfficeExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.xls"), "application/vnd.ms-excel");
+    plugin.extract(&result);
+
+    // The shared strings include formatting runs and phonetic data which have to
+    // be skipped. The fifth string is continued in a CONTINUE record as UTF-16 and
+    // the formatting runs of the sixth one are split over another CONTINUE record.
+    QString content;
+    QTextStream(&content) << "Alpha\n"
+                          << QString::fromUtf8("Gr\xc3\xbc\xc3\x9f" "e\n")
+                          << "Rich\n"
+                          << "Phonetic\n"
+                          << QString::fromUtf8("Long string split over records \xe2\x80\x94 continued\n")
+                          << "After\n"
+                          << "Inline ";
+
+    QCOMPARE(result.types().size(), 2);
+    QCOMPARE(result.types().at(0), Type::Document);
+    QCOMPARE(result.types().at(1), Type::Spreadsheet);
+
+    QCOMPARE(result.text(), content);
+}
+
+void OfficeExtractorTest::testPowerPointDocument()
+{
+    OfficeExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.ppt"), "application/vnd.ms-powerpoint");
+    plugin.extract(&result);
+
+    // The first slide has been saved again incrementally, its old version is
+    // still in the file. The slides are stored in the reverse order.
+    QString content;
+    QTextStream(&content) << "Edited title\n"
+                          << "Current text of the first slide\n"
+                          << "Notes of the first slide\n"
+                          << "Second slide\n"
+                          << QString::fromUtf8("Caf\xc3\xa9 on the second slide ");
+
+    QCOMPARE(result.types().size(), 2);
+    QCOMPARE(result.types().at(0), Type::Document);
+    QCOMPARE(result.types().at(1), Type::Presentation);
+
+    QCOMPARE(result.text(), content);
+}
+
+void OfficeExtractorTest::testSummaryInformation()
+{
+    OfficeExtractor plugin(this, QVariantList());
+
+    // The strings of test.doc are stored in cp1252, the author of test.ppt as UTF-16
+    SimpleResult result(testFilePath("test.doc"), "application/msword");
+    plugin.extract(&result);
+
+    QCOMPARE(result.properties().value(Property::Title), QVariant(QString::fromUtf8("Caf\xc3\xa9 Title")));
+    QCOMPARE(result.properties().value(Property::Author), QVariant(QString::fromUtf8("J\xc3\xbcrgen")));
+    QCOMPARE(result.properties().value(Property::Generator), QVariant(QLatin1String("Microsoft Office Word")));
+    QCOMPARE(result.properties().value(Property::PageCount), QVariant(2));
+    QCOMPARE(result.properties().value(Property::CreationDate).toDateTime(),
+             QDateTime(QDate(2015, 1, 1), QTime(0, 0), Qt::UTC));
+
+    SimpleResult presentationResult(testFilePath("test.ppt"), "application/vnd.ms-powerpoint");
+    plugin.extract(&presentationResult);
+
+    QCOMPARE(presentationResult.properties().value(Property::Title), QVariant(QLatin1String("Presentation Title")));
+    QCOMPARE(presentationResult.properties().value(Property::Author), QVariant(QString::fromUtf8("Zo\xc3\xab Doe")));
+    QCOMPARE(presentationResult.properties().value(Property::SlideCount), QVariant(2));
+    QVERIFY(!presentationResult.properties().contains(Property::PageCount));
+}
+
+void OfficeExtractorTest::testMetaDataOnly()
+{
+    OfficeExtractor plugin(this, QVariantList());
+
+    SimpleResult result(testFilePath("test.doc"), "application/msword", ExtractionResult::ExtractMetaData);
+    plugin.extract(&result);
+
+    QVERIFY(result.text().isEmpty());
+    QCOMPARE(result.properties().value(Property::Title), QVariant(QString::fromUtf8("Caf\xc3\xa9 Title")));
+
+    // Without the text, the word count of the document properties is used
+    QCOMPARE(result.properties().value(Property::WordCount), QVariant(9));
+    QVERIFY(!result.properties().contains(Property::LineCount));
+}
+
+QTEST_KDEMAIN_CORE(OfficeExtractorTest)
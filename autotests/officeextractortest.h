@@ -0,0 +1,41 @@
+/*
+    Tests for the Word, Excel and PowerPoint 97-2003 extractor
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef OFFICEEXTRACTORTEST_H
+#define OFFICEEXTRACTORTEST_H
+
+#include <QObject>
+#include <QString>
+
+class OfficeExtractorTest : public QObject
+{
+    Q_OBJECT
+private:
+    QString testFilePath(const QString& fileName) const;
+
+private slots:
+    void testWordDocument();
+    void testCorruptSectorChain();
+    void testExcelDocument();
+    void testPowerPointDocument();
+    void testSummaryInformation();
+    void testMetaDataOnly();
+};
+
+#endif // OFFICEEXTRACTORTEST_H
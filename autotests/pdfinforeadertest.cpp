@@ -0,0 +1,86 @@
+/*
+    Tests for the reader of the PDF document information
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "pdfinforeadertest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/pdfinforeader.h"
+
+using namespace KFileMetaData;
+
+QString PdfInfoReaderTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void PdfInfoReaderTest::testInfo()
+{
+    PdfInfoReader reader(testFilePath("test_info.pdf"));
+    QVERIFY(reader.isValid());
+
+    // The title is in PDFDocEncoding with octal escapes, the author in UTF-16BE
+    // and the subject in UTF-8 with a byte order mark
+    QCOMPARE(reader.info(QLatin1String("Title")),
+             QString::fromUtf8("Caf\xc3\xa9 \xe2\x80\x9cquoted\xe2\x80\x9d \xe2\x80\x94 (draft)"));
+    QCOMPARE(reader.info(QLatin1String("Author")), QString::fromUtf8("J\xc3\xb6rg"));
+    QCOMPARE(reader.info(QLatin1String("Subject")), QString::fromUtf8("Gr\xc3\xbc\xc3\x9f" "e"));
+    QCOMPARE(reader.info(QLatin1String("Creator")), QString::fromLatin1("Writer"));
+    QVERIFY(reader.info(QLatin1String("Keywords")).isEmpty());
+
+    QCOMPARE(reader.pageCount(), 3);
+
+    // The length of the metadata stream is an indirect object
+    QVERIFY(reader.metadata().startsWith("<?xpacket begin="));
+    QVERIFY(reader.metadata().endsWith("<?xpacket end=\"w\"?>"));
+}
+
+void PdfInfoReaderTest::testIncrementalUpdate()
+{
+    // The update adds a new Info dictionary and marks the metadata stream as
+    // free, which the catalog of the original file still refers to
+    PdfInfoReader reader(testFilePath("test_incremental.pdf"));
+    QVERIFY(reader.isValid());
+
+    QCOMPARE(reader.info(QLatin1String("Title")), QString::fromLatin1("Updated title"));
+    QVERIFY(reader.info(QLatin1String("Author")).isEmpty());
+    QCOMPARE(reader.pageCount(), 3);
+    QVERIFY(reader.metadata().isEmpty());
+}
+
+void PdfInfoReaderTest::testUnsupported_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("encrypted") << QString::fromLatin1("test_encrypted.pdf");
+    QTest::newRow("cross reference stream") << QString::fromLatin1("test_xrefstm.pdf");
+}
+
+void PdfInfoReaderTest::testUnsupported()
+{
+    QFETCH(QString, fileName);
+
+    // These have to be loaded by Poppler instead
+    PdfInfoReader reader(testFilePath(fileName));
+    QVERIFY(!reader.isValid());
+}
+
+QTEST_KDEMAIN_CORE(PdfInfoReaderTest)
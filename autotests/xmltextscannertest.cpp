@@ -0,0 +1,86 @@
+/*
+    Tests for the scanner of XML text elements
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "xmltextscannertest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "extractors/xmltextscanner.h"
+
+using namespace KFileMetaData;
+
+namespace
+{
+QString scan(XmlTextScanner& scanner, const QByteArray& document, int chunkSize)
+{
+    QStringList texts;
+    for (int i = 0; i < document.size(); i += chunkSize) {
+        const QString text = scanner.process(document.constData() + i, qMin(chunkSize, document.size() - i));
+        if (!text.isEmpty())
+            texts << text;
+    }
+    texts << scanner.finish();
+
+    return texts.join(QLatin1String(" "));
+}
+}
+
+void XmlTextScannerTest::testChunks_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("byte") << 1;
+    QTest::newRow("small") << 5;
+    QTest::newRow("whole") << 4096;
+}
+
+void XmlTextScannerTest::testChunks()
+{
+    QFETCH(int, chunkSize);
+
+    const QByteArray document =
+        "<?xml version=\"1.0\"?><!-- <w:t>comment</w:t> -->"
+        "<w:p><w:t a=\"x>y\">Caf&#xE9; &amp; </w:t><w:t>bar</w:t></w:p>"
+        "<w:p><w:t><![CDATA[<raw>]]></w:t><w:rPh><w:t>hint</w:t></w:rPh><w:t>&unknown;</w:t></w:p>";
+
+    XmlTextScanner scanner;
+    scanner.addTextElement("w:t");
+    scanner.addSeparator("w:p", '\n');
+    scanner.addSkippedElement("w:rPh");
+
+    const QString text = scan(scanner, document, chunkSize).simplified();
+    QCOMPARE(text, QString::fromUtf8("Café & bar <raw>&unknown;"));
+}
+
+void XmlTextScannerTest::testLongEmptyTag()
+{
+    // The tag is longer than the part which is kept of it, it still ends with "/>"
+    QByteArray document = "<w:p><w:t";
+    for (int i = 0; i < 40; i++)
+        document += " attribute" + QByteArray::number(i) + "=\"v\"";
+    document += " /><w:t>kept</w:t>skipped</w:p>";
+
+    XmlTextScanner scanner;
+    scanner.addTextElement("w:t");
+
+    QCOMPARE(scan(scanner, document, 7).simplified(), QString::fromLatin1("kept"));
+}
+
+QTEST_KDEMAIN_CORE(XmlTextScannerTest)
@@ -0,0 +1,140 @@
+/*
+    Tests for the reader of XMP metadata packets
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "xmpreadertest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "simpleresult.h"
+#include "extractors/xmpreader.h"
+
+using namespace KFileMetaData;
+
+namespace
+{
+// Simple properties are written as attributes and as elements, spread over several rdf:Description
+const char packet[] =
+    "<?xpacket begin=\"\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?>\n"
+    "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\">\n"
+    " <rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">\n"
+    "  <rdf:Description rdf:about=\"\" xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"\n"
+    "    xmp:CreatorTool=\"Writer\" xmp:CreateDate=\"2015-03-01T10:20:30Z\"/>\n"
+    "  <rdf:Description rdf:about=\"\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+    "    xmlns:pdf=\"http://ns.adobe.com/pdf/1.3/\">\n"
+    "   <dc:title><rdf:Alt><rdf:li xml:lang=\"de\">Titel</rdf:li>"
+    "<rdf:li xml:lang=\"x-default\">Title</rdf:li></rdf:Alt></dc:title>\n"
+    "   <dc:creator><rdf:Seq><rdf:li>First Author</rdf:li><rdf:li>Second Author</rdf:li></rdf:Seq></dc:creator>\n"
+    "   <dc:subject><rdf:Bag><rdf:li>alpha</rdf:li><rdf:li>beta</rdf:li></rdf:Bag></dc:subject>\n"
+    "   <pdf:Keywords>beta, gamma; delta</pdf:Keywords>\n"
+    "   <dc:description><rdf:Alt><rdf:li xml:lang=\"x-default\">Caf&#233; description</rdf:li></rdf:Alt></dc:description>\n"
+    "  </rdf:Description>\n"
+    "  <rdf:Description rdf:about=\"\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+    "    xmlns:tiff=\"http://ns.adobe.com/tiff/1.0/\" tiff:Make=\"Camera Maker\">\n"
+    "   <dc:title><rdf:Alt><rdf:li xml:lang=\"x-default\">Second title</rdf:li></rdf:Alt></dc:title>\n"
+    "   <tiff:Model>Model 1</tiff:Model>\n"
+    "  </rdf:Description>\n"
+    " </rdf:RDF>\n"
+    "</x:xmpmeta>\n"
+    "<?xpacket end=\"w\"?>";
+}
+
+void XmpReaderTest::testProperties()
+{
+    const XmpReader xmp(QByteArray(packet));
+    QVERIFY(!xmp.isEmpty());
+
+    QCOMPARE(xmp.properties(), QList<Property::Property>() << Property::Generator << Property::CreationDate
+                                                           << Property::Title << Property::Author
+                                                           << Property::Keywords << Property::Description
+                                                           << Property::ImageMake << Property::ImageModel);
+
+    QCOMPARE(xmp.values(Property::Generator), QVariantList() << QLatin1String("Writer"));
+    QCOMPARE(xmp.values(Property::CreationDate),
+             QVariantList() << QDateTime(QDate(2015, 3, 1), QTime(10, 20, 30), Qt::UTC));
+
+    // Only the default language, and the first title
+    QCOMPARE(xmp.values(Property::Title), QVariantList() << QLatin1String("Title"));
+    QCOMPARE(xmp.values(Property::Author),
+             QVariantList() << QLatin1String("First Author") << QLatin1String("Second Author"));
+
+    // The subjects and the PDF keywords are merged
+    QCOMPARE(xmp.values(Property::Keywords), QVariantList() << QLatin1String("alpha") << QLatin1String("beta")
+                                                            << QLatin1String("gamma") << QLatin1String("delta"));
+    QCOMPARE(xmp.values(Property::Description), QVariantList() << QString::fromUtf8("Caf\xc3\xa9 description"));
+
+    QCOMPARE(xmp.values(Property::ImageMake), QVariantList() << QLatin1String("Camera Maker"));
+    QCOMPARE(xmp.values(Property::ImageModel), QVariantList() << QLatin1String("Model 1"));
+
+    // The callers use this to let the packet take precedence over older metadata
+    QVERIFY(xmp.contains(Property::ImageMake));
+    QVERIFY(!xmp.contains(Property::PhotoDateTimeOriginal));
+    QVERIFY(xmp.values(Property::PhotoDateTimeOriginal).isEmpty());
+}
+
+void XmpReaderTest::testAddProperties()
+{
+    const XmpReader xmp(QByteArray(packet));
+
+    SimpleResult result(QLatin1String("test.xmp"), QLatin1String("application/rdf+xml"));
+    xmp.addProperties(&result);
+
+    QCOMPARE(result.properties().size(), 12);
+    QCOMPARE(result.properties().value(Property::Title), QVariant(QLatin1String("Title")));
+    QCOMPARE(result.properties().values(Property::Author).size(), 2);
+    QCOMPARE(result.properties().values(Property::Keywords).size(), 4);
+}
+
+void XmpReaderTest::testAddValues()
+{
+    // Decoded XMP, as it comes from Exiv2, is mapped like the packet
+    XmpReader xmp;
+    xmp.addValues(QLatin1String("http://purl.org/dc/elements/1.1/"), QLatin1String("title"),
+                  QStringList() << QLatin1String("Title"));
+    xmp.addValues(QLatin1String("http://purl.org/dc/elements/1.1/"), QLatin1String("title"),
+                  QStringList() << QLatin1String("Second title"));
+    xmp.addValues(QLatin1String("http://ns.adobe.com/pdf/1.3/"), QLatin1String("Keywords"),
+                  QStringList() << QLatin1String("alpha; beta"));
+    xmp.addValues(QLatin1String("http://ns.adobe.com/exif/1.0/"), QLatin1String("DateTimeOriginal"),
+                  QStringList() << QLatin1String("2015-03-01T10:20:30Z"));
+    xmp.addValues(QLatin1String("http://ns.adobe.com/xap/1.0/mm/"), QLatin1String("DocumentID"),
+                  QStringList() << QLatin1String("uuid:1234"));
+
+    QCOMPARE(xmp.properties(), QList<Property::Property>() << Property::Title << Property::Keywords
+                                                           << Property::PhotoDateTimeOriginal);
+    QCOMPARE(xmp.values(Property::Title), QVariantList() << QLatin1String("Title"));
+    QCOMPARE(xmp.values(Property::Keywords), QVariantList() << QLatin1String("alpha") << QLatin1String("beta"));
+    QCOMPARE(xmp.values(Property::PhotoDateTimeOriginal),
+             QVariantList() << QDateTime(QDate(2015, 3, 1), QTime(10, 20, 30), Qt::UTC));
+}
+
+void XmpReaderTest::testInvalid()
+{
+    QVERIFY(XmpReader(QByteArray()).isEmpty());
+    QVERIFY(XmpReader(QByteArray("not xml at all")).isEmpty());
+
+    // The properties before the point where a damaged packet ends are kept
+    const QByteArray truncated = QByteArray(packet).left(QByteArray(packet).indexOf("<dc:subject>"));
+    const XmpReader xmp(truncated);
+    QCOMPARE(xmp.values(Property::Title), QVariantList() << QLatin1String("Title"));
+    QVERIFY(xmp.contains(Property::Author));
+    QVERIFY(!xmp.contains(Property::Keywords));
+}
+
+QTEST_KDEMAIN_CORE(XmpReaderTest)
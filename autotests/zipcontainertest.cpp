@@ -0,0 +1,110 @@
+/*
+    Tests for the ZIP container reader
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "zipcontainertest.h"
+
+#include <QtTest>
+#include "qtest_kde.h"
+#include "indexerextractortestsconfig.h"
+#include "extractors/zipcontainer.h"
+
+using namespace KFileMetaData;
+
+QString ZipContainerTest::testFilePath(const QString& fileName) const
+{
+    return QLatin1String(INDEXER_TESTS_SAMPLE_FILES_PATH) + QDir::separator() + fileName;
+}
+
+void ZipContainerTest::testEntries_data()
+{
+    QTest::addColumn<bool>("allowMapping");
+
+    QTest::newRow("mapped") << true;
+    QTest::newRow("read") << false;
+}
+
+void ZipContainerTest::testEntries()
+{
+    QFETCH(bool, allowMapping);
+
+    ZipContainer zip(testFilePath("test_entries.zip"), allowMapping);
+    QVERIFY(zip.isValid());
+
+    QCOMPARE(zip.entries(), QStringList() << QLatin1String("stored.txt") << QLatin1String("dir/deflated.xml"));
+    QVERIFY(zip.contains(QLatin1String("dir/deflated.xml")));
+    QVERIFY(!zip.contains(QLatin1String("deflated.xml")));
+    QVERIFY(!zip.device(QLatin1String("missing.txt")));
+
+    QCOMPARE(zip.data(QLatin1String("stored.txt")), QByteArray("Stored entry"));
+
+    QByteArray expected;
+    for (int i = 0; i < 5000; i++)
+        expected += "<p>Line " + QByteArray::number(i) + " of the deflated entry</p>\n";
+
+    // Read in small pieces, so that inflating has to stop and resume many times
+    QScopedPointer<QIODevice> device(zip.device(QLatin1String("dir/deflated.xml")));
+    QVERIFY(device);
+    QCOMPARE(device->size(), qint64(expected.size()));
+
+    QByteArray data;
+    char buffer[1000];
+    qint64 size;
+    while ((size = device->read(buffer, sizeof(buffer))) > 0)
+        data.append(buffer, size);
+
+    QCOMPARE(data, expected);
+    QCOMPARE(zip.data(QLatin1String("dir/deflated.xml"), 100), expected.left(100));
+}
+
+void ZipContainerTest::testOversizedEntry()
+{
+    // The entry claims to be 100 bytes, but inflates to 1000
+    ZipContainer zip(testFilePath("test_oversized_entry.zip"));
+    QVERIFY(zip.isValid());
+
+    QCOMPARE(zip.data(QLatin1String("entry.txt")), QByteArray(100, 'x'));
+}
+
+void ZipContainerTest::testCorruptDirectory()
+{
+    QFile file(testFilePath("test_entries.zip"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+
+    // The end of central directory record is cut off
+    QTemporaryFile truncated;
+    QVERIFY(truncated.open());
+    truncated.write(data.left(data.size() - 10));
+    truncated.flush();
+
+    QVERIFY(!ZipContainer(truncated.fileName()).isValid());
+
+    // The headers of the central directory are broken
+    QByteArray broken = data;
+    broken.replace("PK\x01\x02", "XX\x01\x02");
+
+    QTemporaryFile corrupt;
+    QVERIFY(corrupt.open());
+    corrupt.write(broken);
+    corrupt.flush();
+
+    QVERIFY(!ZipContainer(corrupt.fileName()).isValid());
+}
+
+QTEST_KDEMAIN_CORE(ZipContainerTest)
@@ -25,15 +25,42 @@ using namespace KFileMetaData;
 
 class ExtractionResult::Private {
 public:
+    void init(const QString& inputUrl, const QString& inputMimetype, const Flags& inputFlags)
+    {
+        url = inputUrl;
+        mimetype = inputMimetype;
+        flags = inputFlags;
+        textBudget = 0;
+        timeLimit = 0;
+        parallelism = 1;
+        hasAppendState = false;
+        appendStateSize = 0;
+        appendStateLineCount = 0;
+    }
+
     QString url;
     QString mimetype;
+    Flags flags;
+    int textBudget;
+    int timeLimit;
+    int parallelism;
+
+    bool hasAppendState;
+    qint64 appendStateSize;
+    int appendStateLineCount;
+    QByteArray appendStateTailHash;
 };
 
 ExtractionResult::ExtractionResult(const QString& url, const QString& mimetype)
     : d(new Private)
 {
-    d->url = url;
-    d->mimetype = mimetype;
+    d->init(url, mimetype, ExtractEverything);
+}
+
+ExtractionResult::ExtractionResult(const QString& url, const QString& mimetype, const Flags& flags)
+    : d(new Private)
+{
+    d->init(url, mimetype, flags);
 }
 
 ExtractionResult::ExtractionResult(const ExtractionResult& rhs)
@@ -55,3 +82,66 @@ QString ExtractionResult::inputMimetype() const
 {
     return d->mimetype;
 }
+
+ExtractionResult::Flags ExtractionResult::inputFlags() const
+{
+    return d->flags;
+}
+
+void ExtractionResult::setTextBudget(int characters)
+{
+    d->textBudget = characters;
+}
+
+int ExtractionResult::textBudget() const
+{
+    return d->textBudget;
+}
+
+void ExtractionResult::setTimeLimit(int msecs)
+{
+    d->timeLimit = msecs;
+}
+
+int ExtractionResult::timeLimit() const
+{
+    return d->timeLimit;
+}
+
+void ExtractionResult::setParallelism(int threads)
+{
+    d->parallelism = qMax(1, threads);
+}
+
+int ExtractionResult::parallelism() const
+{
+    return d->parallelism;
+}
+
+void ExtractionResult::setAppendState(qint64 size, int lineCount, const QByteArray& tailHash)
+{
+    d->hasAppendState = true;
+    d->appendStateSize = size;
+    d->appendStateLineCount = lineCount;
+    d->appendStateTailHash = tailHash;
+}
+
+bool ExtractionResult::hasAppendState() const
+{
+    return d->hasAppendState;
+}
+
+qint64 ExtractionResult::appendStateSize() const
+{
+    return d->appendStateSize;
+}
+
+int ExtractionResult::appendStateLineCount() const
+{
+    return d->appendStateLineCount;
+}
+
+QByteArray ExtractionResult::appendStateTailHash() const
+{
+    return d->appendStateTailHash;
+}
@@ -22,6 +22,7 @@
 #ifndef _KFILEMETADATA_EXTRACTIONRESULT_H
 #define _KFILEMETADATA_EXTRACTIONRESULT_H
 
+#include <QByteArray>
 #include <QString>
 #include <QVariant>
 
@@ -46,7 +47,41 @@ namespace KFileMetaData {
 class KFILEMETADATA_EXPORT ExtractionResult
 {
 public:
+    /**
+     * The different kinds of data which can be extracted. Plugins which
+     * support it skip the work for the parts which are not requested,
+     * eg - only reading the document properties when just the metadata
+     * is needed.
+     */
+    enum Flag {
+        ExtractNothing = 0,
+        ExtractMetaData = 1,
+        ExtractPlainText = 2,
+        ExtractEverything = ExtractMetaData | ExtractPlainText,
+
+        /**
+         * The plain text is only needed for its words, eg - for indexing.
+         * Plugins may then return it in the order in which it is stored,
+         * instead of reconstructing the reading order of the layout.
+         */
+        ExtractRawOrderText = 4,
+
+        /**
+         * The caller stores the append state of the file after the
+         * extraction. Plugins only compute it when this is set or when
+         * a previous state has been passed with setAppendState().
+         */
+        ExtractAppendState = 8
+    };
+    Q_DECLARE_FLAGS(Flags, Flag)
+
     ExtractionResult(const QString& url, const QString& mimetype);
+
+    /**
+     * Only the kinds of data in \p flags are extracted. The other
+     * constructor extracts everything.
+     */
+    ExtractionResult(const QString& url, const QString& mimetype, const Flags& flags);
     ExtractionResult(const ExtractionResult& rhs);
     virtual ~ExtractionResult();
 
@@ -62,6 +97,11 @@ public:
      */
     QString inputMimetype() const;
 
+    /**
+     * The kinds of data which should be extracted
+     */
+    Flags inputFlags() const;
+
     /**
      * This function is called by plugins when they wish for some plain
      * text to be indexed without any property. This generally corresponds
@@ -90,11 +130,71 @@ public:
      */
     virtual void addType(Type::Type type) = 0;
 
+    /**
+     * Sets the maximum number of \p characters of plain text the plugins
+     * should extract. Plugins which support it stop reading the file
+     * once they have passed on that much text.
+     *
+     * By default, or when set to 0, there is no limit.
+     */
+    void setTextBudget(int characters);
+    int textBudget() const;
+
+    /**
+     * Sets the maximum time in \p msecs the plugins should spend on the
+     * file. Plugins which run slow external tools stop them once the
+     * limit has been reached and keep the text extracted so far.
+     *
+     * By default, or when set to 0, there is no limit.
+     */
+    void setTimeLimit(int msecs);
+    int timeLimit() const;
+
+    /**
+     * Sets the maximum number of \p threads the plugins may use for a
+     * single file. Plugins which support it process independent parts
+     * of large documents at the same time, the text is still passed on
+     * in the order of the document.
+     *
+     * The default is 1, everything is done in the calling thread.
+     */
+    void setParallelism(int threads);
+    int parallelism() const;
+
+    /**
+     * Set the state of a file as it was at the end of a previous
+     * extraction. Plugins which support incremental extraction of
+     * append-only files (such as logs) verify that the file has only
+     * been appended to since then and only process the new data.
+     *
+     * \p size The number of bytes of the file which were processed
+     * \p lineCount The number of lines in those bytes
+     * \p tailHash A hash of the last bytes which were processed
+     *
+     * Plugins which support it update the state at the end of the
+     * extraction, so that it can be stored and passed again the next
+     * time the same file is extracted. Use ExtractAppendState to get
+     * the state of a file which has not been extracted before.
+     */
+    void setAppendState(qint64 size, int lineCount, const QByteArray& tailHash);
+
+    /**
+     * Returns true if an append state has been set, either by the
+     * caller or by a plugin at the end of an extraction
+     */
+    bool hasAppendState() const;
+
+    qint64 appendStateSize() const;
+    int appendStateLineCount() const;
+    QByteArray appendStateTailHash() const;
+
 private:
     class Private;
     Private* d;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(ExtractionResult::Flags)
+
 }
 
 #endif // _KFILEMETADATA_EXTRACTIONRESULT_H
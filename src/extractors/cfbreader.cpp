@@ -0,0 +1,396 @@
+/*
+    Reader for the Compound File Binary (OLE2) container
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "cfbreader.h"
+
+#include <string.h>
+
+using namespace KFileMetaData;
+
+namespace
+{
+const quint32 maxRegularSector = 0xFFFFFFFA;
+const quint32 endOfChain = 0xFFFFFFFE;
+const quint32 noStream = 0xFFFFFFFF;
+const int headerSize = 512;
+const int directoryEntrySize = 128;
+const int headerDifatEntries = 109;
+
+enum EntryType {
+    EmptyEntry = 0,
+    StorageEntry = 1,
+    StreamEntry = 2,
+    RootEntry = 5
+};
+}
+
+CfbReader::Stream::Stream()
+    : m_valid(false)
+    , m_mini(false)
+    , m_size(0)
+{
+}
+
+bool CfbReader::Stream::isValid() const
+{
+    return m_valid;
+}
+
+qint64 CfbReader::Stream::size() const
+{
+    return m_size;
+}
+
+CfbReader::CfbReader(const QString& fileName)
+    : m_file(fileName)
+    , m_valid(false)
+    , m_sectorShift(9)
+    , m_miniSectorShift(6)
+    , m_miniStreamCutoff(4096)
+    , m_maxSectors(0)
+    , m_fatSectorCount(0)
+    , m_firstDifatSector(endOfChain)
+    , m_difatLoaded(false)
+    , m_firstMiniFatSector(endOfChain)
+    , m_miniStreamLoaded(false)
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+
+    char header[headerSize];
+    if (m_file.read(header, headerSize) != headerSize)
+        return;
+
+    static const char signature[] = "\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1";
+    if (memcmp(header, signature, 8) != 0 || readUInt16(header + 0x1C) != 0xFFFE)
+        return;
+
+    m_sectorShift = readUInt16(header + 0x1E);
+    m_miniSectorShift = readUInt16(header + 0x20);
+    if ((m_sectorShift != 9 && m_sectorShift != 12) || m_miniSectorShift != 6)
+        return;
+
+    const int sectorSize = 1 << m_sectorShift;
+    m_maxSectors = m_file.size() / sectorSize;
+
+    m_fatSectorCount = readUInt32(header + 0x2C);
+    const quint32 firstDirectorySector = readUInt32(header + 0x30);
+    m_miniStreamCutoff = readUInt32(header + 0x38);
+    m_firstMiniFatSector = readUInt32(header + 0x3C);
+    m_firstDifatSector = readUInt32(header + 0x44);
+
+    if (m_fatSectorCount > m_maxSectors)
+        return;
+
+    m_fat.resize(m_fatSectorCount);
+    for (int i = 0; i < headerDifatEntries && quint32(i) < m_fatSectorCount; i++) {
+        m_difat << readUInt32(header + 0x4C + i * 4);
+    }
+    m_difatLoaded = m_fatSectorCount <= quint32(headerDifatEntries);
+
+    // The directory is usually just a couple of sectors
+    const QVector<quint32> directorySectors = chain(firstDirectorySector, false);
+    if (directorySectors.isEmpty())
+        return;
+
+    QByteArray sector;
+    sector.resize(sectorSize);
+    foreach (quint32 sectorNumber, directorySectors) {
+        if (!readAt(qint64(sectorNumber + 1) << m_sectorShift, sector.data(), sectorSize))
+            return;
+
+        for (int offset = 0; offset < sectorSize; offset += directoryEntrySize) {
+            const char* data = sector.constData() + offset;
+
+            DirectoryEntry entry;
+            const int nameLength = qMin<int>(readUInt16(data + 0x40), 64);
+            entry.name = QString::fromUtf16(reinterpret_cast<const ushort*>(data), qMax(0, nameLength / 2 - 1));
+            entry.type = data[0x42];
+            entry.left = readUInt32(data + 0x44);
+            entry.right = readUInt32(data + 0x48);
+            entry.child = readUInt32(data + 0x4C);
+            entry.start = readUInt32(data + 0x74);
+            entry.size = readUInt32(data + 0x78);
+
+            // Only version 4 files can have streams larger than 4 GiB
+            if (m_sectorShift == 12)
+                entry.size |= qint64(readUInt32(data + 0x7C)) << 32;
+
+            m_entries << entry;
+        }
+    }
+
+    if (m_entries.isEmpty() || m_entries.first().type != RootEntry)
+        return;
+
+    m_valid = true;
+}
+
+bool CfbReader::isValid() const
+{
+    return m_valid;
+}
+
+CfbReader::Stream CfbReader::stream(const QString& name)
+{
+    Stream stream;
+    if (!m_valid)
+        return stream;
+
+    // The children of a storage are kept in a tree, walk all of it
+    QVector<quint32> pending;
+    pending << m_entries.first().child;
+
+    int visited = 0;
+    while (!pending.isEmpty() && visited++ < m_entries.size()) {
+        const quint32 index = pending.last();
+        pending.pop_back();
+
+        if (index >= quint32(m_entries.size()))
+            continue;
+
+        const DirectoryEntry& entry = m_entries.at(index);
+        if (entry.type == StreamEntry && entry.name.compare(name, Qt::CaseInsensitive) == 0) {
+            stream.m_mini = entry.size < m_miniStreamCutoff;
+            if (stream.m_mini && entry.size > 0 && !loadMiniStream())
+                return stream;
+
+            stream.m_sectors = chain(entry.start, stream.m_mini);
+            if (stream.m_sectors.isEmpty() && entry.size > 0)
+                return stream;
+
+            const int shift = stream.m_mini ? m_miniSectorShift : m_sectorShift;
+            stream.m_size = qMin(entry.size, qint64(stream.m_sectors.size()) << shift);
+            stream.m_valid = true;
+            return stream;
+        }
+
+        if (entry.left != noStream)
+            pending << entry.left;
+        if (entry.right != noStream)
+            pending << entry.right;
+    }
+
+    return stream;
+}
+
+qint64 CfbReader::read(const Stream& stream, qint64 offset, char* data, qint64 maxSize)
+{
+    if (!stream.m_valid || offset < 0)
+        return -1;
+
+    const int shift = stream.m_mini ? m_miniSectorShift : m_sectorShift;
+    const qint64 sectorSize = qint64(1) << shift;
+    const qint64 end = qMin(stream.m_size, offset + maxSize);
+
+    qint64 position = offset;
+    while (position < end) {
+        int index = position >> shift;
+        const qint64 inSector = position & (sectorSize - 1);
+        qint64 size = qMin(sectorSize - inSector, end - position);
+
+        qint64 filePosition;
+        if (stream.m_mini) {
+            const qint64 miniPosition = (qint64(stream.m_sectors.at(index)) << m_miniSectorShift) + inSector;
+            const int miniStreamIndex = miniPosition >> m_sectorShift;
+            if (miniStreamIndex >= m_miniStreamSectors.size())
+                return -1;
+
+            filePosition = (qint64(m_miniStreamSectors.at(miniStreamIndex) + 1) << m_sectorShift)
+                           + (miniPosition & ((qint64(1) << m_sectorShift) - 1));
+        } else {
+            filePosition = (qint64(stream.m_sectors.at(index) + 1) << m_sectorShift) + inSector;
+
+            // Read runs of consecutive sectors at once
+            while (position + size < end && index + 1 < stream.m_sectors.size() &&
+                    stream.m_sectors.at(index + 1) == stream.m_sectors.at(index) + 1) {
+                index++;
+                size = qMin(size + sectorSize, end - position);
+            }
+        }
+
+        if (!readAt(filePosition, data + (position - offset), size))
+            return -1;
+
+        position += size;
+    }
+
+    return position - offset;
+}
+
+QByteArray CfbReader::read(const Stream& stream, qint64 offset, qint64 size)
+{
+    if (!stream.m_valid || size < 0 || offset + size > stream.m_size)
+        return QByteArray();
+
+    QByteArray data;
+    data.resize(size);
+    if (read(stream, offset, data.data(), size) != size)
+        return QByteArray();
+
+    return data;
+}
+
+bool CfbReader::readAt(qint64 position, char* data, qint64 size)
+{
+    return m_file.seek(position) && m_file.read(data, size) == size;
+}
+
+quint32 CfbReader::fatSectorLocation(quint32 index)
+{
+    if (index >= m_fatSectorCount)
+        return endOfChain;
+
+    // Files larger than ~7 MiB keep the rest of the FAT locations in a chain of DIFAT sectors
+    if (!m_difatLoaded) {
+        m_difatLoaded = true;
+
+        const int sectorSize = 1 << m_sectorShift;
+        const int entriesPerSector = sectorSize / 4 - 1;
+
+        QByteArray sector;
+        sector.resize(sectorSize);
+
+        quint32 difatSector = m_firstDifatSector;
+        quint32 count = 0;
+        while (difatSector < m_maxSectors && quint32(m_difat.size()) < m_fatSectorCount && count++ < m_maxSectors) {
+            if (!readAt(qint64(difatSector + 1) << m_sectorShift, sector.data(), sectorSize))
+                break;
+
+            for (int i = 0; i < entriesPerSector && quint32(m_difat.size()) < m_fatSectorCount; i++) {
+                m_difat << readUInt32(sector.constData() + i * 4);
+            }
+            difatSector = readUInt32(sector.constData() + entriesPerSector * 4);
+        }
+    }
+
+    if (index >= quint32(m_difat.size()))
+        return endOfChain;
+
+    return m_difat.at(index);
+}
+
+quint32 CfbReader::nextSector(quint32 sector)
+{
+    const int sectorSize = 1 << m_sectorShift;
+    const quint32 entriesPerSector = sectorSize / 4;
+    const quint32 fatIndex = sector / entriesPerSector;
+
+    if (fatIndex >= quint32(m_fat.size()))
+        return endOfChain;
+
+    QByteArray& fatSector = m_fat[fatIndex];
+    if (fatSector.isEmpty()) {
+        const quint32 location = fatSectorLocation(fatIndex);
+        if (location >= m_maxSectors)
+            return endOfChain;
+
+        fatSector.resize(sectorSize);
+        if (!readAt(qint64(location + 1) << m_sectorShift, fatSector.data(), sectorSize)) {
+            fatSector.clear();
+            return endOfChain;
+        }
+    }
+
+    return readUInt32(fatSector.constData() + (sector % entriesPerSector) * 4);
+}
+
+quint32 CfbReader::nextMiniSector(quint32 sector)
+{
+    if ((qint64(sector) + 1) * 4 > m_miniFat.size())
+        return endOfChain;
+
+    return readUInt32(m_miniFat.constData() + sector * 4);
+}
+
+QVector<quint32> CfbReader::chain(quint32 start, bool mini)
+{
+    QVector<quint32> sectors;
+
+    // The chain cannot be longer than the file, so a longer one has to be a loop
+    const quint32 maxLength = mini ? m_miniFat.size() / 4 : m_maxSectors;
+
+    quint32 sector = start;
+    while (sector != endOfChain) {
+        // Free sectors, sectors past the end of the file and loops mean the chain is corrupt
+        if (sector > maxRegularSector || (!mini && sector >= m_maxSectors) ||
+                quint32(sectors.size()) >= maxLength)
+            return QVector<quint32>();
+
+        sectors << sector;
+        sector = mini ? nextMiniSector(sector) : nextSector(sector);
+    }
+
+    return sectors;
+}
+
+bool CfbReader::loadMiniStream()
+{
+    if (m_miniStreamLoaded)
+        return !m_miniStreamSectors.isEmpty();
+
+    m_miniStreamLoaded = true;
+
+    const QVector<quint32> miniFatSectors = chain(m_firstMiniFatSector, false);
+    const int sectorSize = 1 << m_sectorShift;
+
+    m_miniFat.resize(miniFatSectors.size() * sectorSize);
+    for (int i = 0; i < miniFatSectors.size(); i++) {
+        if (!readAt(qint64(miniFatSectors.at(i) + 1) << m_sectorShift, m_miniFat.data() + i * sectorSize, sectorSize)) {
+            m_miniFat.clear();
+            return false;
+        }
+    }
+
+    // The mini stream is stored in the sectors of the root entry
+    m_miniStreamSectors = chain(m_entries.first().start, false);
+    return !m_miniStreamSectors.isEmpty();
+}
+
+StreamBuffer::StreamBuffer(CfbReader& reader, const CfbReader::Stream& stream)
+    : m_reader(reader)
+    , m_stream(stream)
+    , m_bufferStart(0)
+{
+}
+
+const char* StreamBuffer::data(qint64 position, int size)
+{
+    if (position < 0 || size < 0 || position + size > m_stream.size())
+        return 0;
+
+    if (position < m_bufferStart || position + size > m_bufferStart + m_buffer.size()) {
+        const qint64 blockSize = qMin(qMax<qint64>(size, 64 * 1024), m_stream.size() - position);
+
+        m_buffer.resize(blockSize);
+        m_bufferStart = position;
+        if (m_reader.read(m_stream, position, m_buffer.data(), blockSize) != blockSize) {
+            m_buffer.clear();
+            return 0;
+        }
+    }
+
+    return m_buffer.constData() + (position - m_bufferStart);
+}
+
+qint64 StreamBuffer::size() const
+{
+    return m_stream.size();
+}
@@ -0,0 +1,176 @@
+/*
+    Reader for the Compound File Binary (OLE2) container
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef CFB_READER_H
+#define CFB_READER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+
+namespace KFileMetaData
+{
+
+/**
+ * \class CfbReader cfbreader.h
+ *
+ * \brief Reads streams out of a Compound File Binary (OLE2) file, the
+ * container used by the binary Word, Excel and PowerPoint formats.
+ *
+ * Only the sectors which are actually needed are read. The allocation
+ * table is loaded lazily, so looking at a small stream such as the
+ * SummaryInformation only costs a few sectors of I/O.
+ */
+class CfbReader
+{
+public:
+    class Stream
+    {
+    public:
+        Stream();
+
+        bool isValid() const;
+        qint64 size() const;
+
+    private:
+        bool m_valid;
+        bool m_mini;
+        qint64 m_size;
+        QVector<quint32> m_sectors;
+
+        friend class CfbReader;
+    };
+
+    explicit CfbReader(const QString& fileName);
+
+    /**
+     * Returns true if the file is a valid compound file
+     */
+    bool isValid() const;
+
+    /**
+     * Looks up a stream in the root storage. The lookup is case insensitive.
+     * An invalid stream is returned if it does not exist.
+     */
+    Stream stream(const QString& name);
+
+    /**
+     * Reads up to \p maxSize bytes of \p stream, starting at \p offset,
+     * into \p data and returns the number of bytes read, or -1 on error.
+     */
+    qint64 read(const Stream& stream, qint64 offset, char* data, qint64 maxSize);
+
+    /**
+     * Convenience function which reads \p size bytes at \p offset.
+     * An empty array is returned if the stream is not large enough.
+     */
+    QByteArray read(const Stream& stream, qint64 offset, qint64 size);
+
+private:
+    struct DirectoryEntry {
+        QString name;
+        quint8 type;
+        quint32 left;
+        quint32 right;
+        quint32 child;
+        quint32 start;
+        qint64 size;
+    };
+
+    bool readAt(qint64 position, char* data, qint64 size);
+    quint32 nextSector(quint32 sector);
+    quint32 nextMiniSector(quint32 sector);
+    quint32 fatSectorLocation(quint32 index);
+    QVector<quint32> chain(quint32 start, bool mini);
+    bool loadMiniStream();
+
+    QFile m_file;
+    bool m_valid;
+
+    int m_sectorShift;
+    int m_miniSectorShift;
+    quint32 m_miniStreamCutoff;
+    quint32 m_maxSectors;
+
+    quint32 m_fatSectorCount;
+    quint32 m_firstDifatSector;
+    QVector<quint32> m_difat;
+    bool m_difatLoaded;
+
+    // FAT sectors are loaded on demand
+    QVector<QByteArray> m_fat;
+
+    quint32 m_firstMiniFatSector;
+    QByteArray m_miniFat;
+    QVector<quint32> m_miniStreamSectors;
+    bool m_miniStreamLoaded;
+
+    QVector<DirectoryEntry> m_entries;
+};
+
+/**
+ * \class StreamBuffer cfbreader.h
+ *
+ * \brief Buffered access to a stream made of many small records.
+ *
+ * Reads the stream in large blocks, so that walking millions of records
+ * does not result in millions of small reads.
+ */
+class StreamBuffer
+{
+public:
+    StreamBuffer(CfbReader& reader, const CfbReader::Stream& stream);
+
+    /**
+     * Returns a pointer to \p size bytes at \p position in the stream,
+     * or 0 if the stream is not large enough. The pointer is valid until
+     * the next call.
+     */
+    const char* data(qint64 position, int size);
+
+    qint64 size() const;
+
+private:
+    CfbReader& m_reader;
+    CfbReader::Stream m_stream;
+
+    QByteArray m_buffer;
+    qint64 m_bufferStart;
+};
+
+//
+// Helpers for the little endian records stored in the streams
+//
+
+inline quint16 readUInt16(const char* data)
+{
+    return qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(data));
+}
+
+inline quint32 readUInt32(const char* data)
+{
+    return qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(data));
+}
+
+}
+
+#endif // CFB_READER_H
@@ -18,12 +18,18 @@
 
 
 #include "epubextractor.h"
-
-#include <epub.h>
+#include "markupstripper.h"
+#include "partextraction.h"
+#include "zipcontainer.h"
 
 #include <KDebug>
 #include <QDateTime>
-#include <QTextDocument>
+#include <QDir>
+#include <QHash>
+#include <QScopedPointer>
+#include <QSet>
+#include <QUrl>
+#include <QXmlStreamReader>
 
 using namespace KFileMetaData;
 
@@ -43,142 +49,290 @@ QStringList EPubExtractor::mimetypes() const
 
 namespace
 {
-QString fetchMetadata(struct epub* e, const epub_metadata& type)
+const char* const dcNamespace = "http://purl.org/dc/elements/1.1/";
+
+/**
+ * Returns the full path of the entry which \p href refers to, relative to
+ * \p directory. The fragment, which only points into the entry, is removed.
+ */
+QString resolvePath(const QString& directory, const QString& href)
 {
-    int size = 0;
-
-    unsigned char** data = epub_get_metadata(e, type, &size);
-    if (data) {
-        QStringList strList;
-        for (int i = 0; i < size; i++) {
-            strList << QString::fromUtf8((char*)data[i]);
-            free(data[i]);
-        }
-        free(data);
+    QString path = href;
+    const int hash = path.indexOf(QLatin1Char('#'));
+    if (hash != -1)
+        path.truncate(hash);
+
+    if (path.isEmpty())
+        return QString();
+
+    return QDir::cleanPath(directory + QUrl::fromPercentEncoding(path.toUtf8()));
+}
+
+QString directoryOf(const QString& path)
+{
+    return path.left(path.lastIndexOf(QLatin1Char('/')) + 1);
+}
 
-        return strList.join(";");
+QString attributeValue(const QXmlStreamAttributes& attributes, const char* name)
+{
+    // The opf: attributes of the metadata are looked up without their namespace
+    foreach (const QXmlStreamAttribute& attribute, attributes) {
+        if (attribute.name() == QLatin1String(name))
+            return attribute.value().toString();
     }
     return QString();
 }
-}
 
+/**
+ * Returns the path of the package document, which META-INF/container.xml
+ * points to
+ */
+QString packagePath(ZipContainer& zip)
+{
+    QXmlStreamReader xml(zip.data(QLatin1String("META-INF/container.xml")));
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement() && xml.name() == QLatin1String("rootfile")) {
+            const QString path = xml.attributes().value(QLatin1String("full-path")).toString();
+            if (!path.isEmpty())
+                return path;
+        }
+    }
 
-void EPubExtractor::extract(ExtractionResult* result)
+    // Without a usable container, look for the package document itself
+    foreach (const QString& entryName, zip.entries()) {
+        if (entryName.endsWith(QLatin1String(".opf")))
+            return entryName;
+    }
+
+    return QString();
+}
+
+/**
+ * Returns the content documents which the navigation map \p ncxPath
+ * links to, in the order of the map
+ */
+QStringList readNavigationMap(ZipContainer& zip, const QString& ncxPath)
 {
-    struct epub* ePubDoc = epub_open(result->inputUrl().toUtf8().constData(), 1);
-    if (!ePubDoc) {
-        kError() << "Invalid document";
-        return;
+    QStringList paths;
+    QSet<QString> seen;
+    const QString directory = directoryOf(ncxPath);
+
+    QXmlStreamReader xml(zip.data(ncxPath));
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement() && xml.name() == QLatin1String("content")) {
+            const QString path = resolvePath(directory, xml.attributes().value(QLatin1String("src")).toString());
+            if (!path.isEmpty() && !seen.contains(path)) {
+                seen.insert(path);
+                paths << path;
+            }
+        }
     }
 
-    result->addType(Type::Document);
+    return paths;
+}
+
+/**
+ * Inflates and converts a single chapter
+ */
+class ChapterConverter
+{
+public:
+    typedef QString result_type;
 
-    QString value = fetchMetadata(ePubDoc, EPUB_TITLE);
-    if (!value.isEmpty()) {
-        result->add(Property::Title, value);
+    explicit ChapterConverter(ZipContainer& zip)
+        : m_zip(zip)
+    {
     }
 
-    value = fetchMetadata(ePubDoc, EPUB_SUBJECT);
-    if (!value.isEmpty()) {
-        result->add(Property::Subject, value);
+    QString operator()(const QString& path) const
+    {
+        QStringList texts;
+        convert(path, &texts, 0);
+        return texts.join(QLatin1String("\n"));
     }
 
-    value = fetchMetadata(ePubDoc, EPUB_CREATOR);
-    if (!value.isEmpty()) {
-        if (value.startsWith(QLatin1String("aut:"), Qt::CaseInsensitive)) {
-            value = value.mid(4).simplified();
-        } else if (value.startsWith(QLatin1String("author:"), Qt::CaseInsensitive)) {
-            value = value.mid(7).simplified();
-        }
+    void extract(const QString& path, ExtractionResult* result) const
+    {
+        convert(path, 0, result);
+    }
+
+private:
+    /**
+     * Converts the chapter \p path, its text is either appended to \p texts
+     * or handed on to \p result as it is converted
+     */
+    void convert(const QString& path, QStringList* texts, ExtractionResult* result) const
+    {
+        QScopedPointer<QIODevice> device(m_zip.device(path));
+        if (!device)
+            return;
 
-        // A lot of authors have their name written in () again. We discard that part
-        int index = value.indexOf('(');
-        if (index)
-            value = value.mid(0, index);
+        // The titles of the chapters usually repeat the title of the book
+        MarkupStripper stripper(MarkupStripper::Html, MarkupStripper::ExcludeTitle);
 
-        result->add(Property::Creator, value);
+        QByteArray buffer;
+        buffer.resize(64 * 1024);
+
+        qint64 size;
+        while ((size = device->read(buffer.data(), buffer.size())) > 0)
+            addText(stripper.process(buffer.constData(), size), texts, result);
+
+        addText(stripper.finish(), texts, result);
     }
 
-    // The Contributor just seems to be mostly Calibre aka the Generator
-    /*
-    value = fetchMetadata(ePubDoc, EPUB_CONTRIB);
-    if( !value.isEmpty() ) {
-        SimpleResource con;
-        con.addType( NCO::Contact() );
-        con.addProperty( NCO::fullname(), value );
-
-        fileRes.addProperty( NCO::contributor(), con );
-        graph << con;
-    }*/
-
-    value = fetchMetadata(ePubDoc, EPUB_PUBLISHER);
-    if (!value.isEmpty()) {
-        result->add(Property::Publisher, value);
+    static void addText(const QString& text, QStringList* texts, ExtractionResult* result)
+    {
+        if (text.isEmpty())
+            return;
+
+        if (texts)
+            *texts << text;
+        else
+            result->append(text);
     }
 
-    value = fetchMetadata(ePubDoc, EPUB_DESCRIPTION);
-    if (!value.isEmpty()) {
-        result->add(Property::Description, value);
+    ZipContainer& m_zip;
+};
+}
+
+void EPubExtractor::extract(ExtractionResult* result)
+{
+    ZipContainer zip(result->inputUrl());
+    if (!zip.isValid()) {
+        kError() << "Invalid document";
+        return;
     }
 
-    value = fetchMetadata(ePubDoc, EPUB_DATE);
-    if (!value.isEmpty()) {
-        if (value.startsWith("Unspecified:", Qt::CaseInsensitive)) {
-            value = value.mid(QString("Unspecified:").size()).simplified();
-        }
-        int ind = value.indexOf("publication:", Qt::CaseInsensitive);
-        if (ind != -1) {
-            value = value.mid(ind + QString("publication:").size()).simplified();
-        }
-        QDateTime dt = ExtractorPlugin::dateTimeFromString(value);
-        if (!dt.isNull())
-            result->add(Property::CreationDate, value);
+    const QString opfPath = packagePath(zip);
+    if (opfPath.isEmpty()) {
+        kError() << "Invalid document structure (the package document is missing)";
+        return;
     }
 
-    //
-    // Plain Text
-    //
-    struct eiterator* iter = epub_get_iterator(ePubDoc, EITERATOR_SPINE, 0);
-    do {
-        char* curr = epub_it_get_curr(iter);
-        if (!curr)
-            continue;
-        QString html = QString::fromUtf8(curr);
+    result->addType(Type::Document);
+
+    const QString opfDirectory = directoryOf(opfPath);
 
-        QTextDocument doc;
-        doc.setHtml(html);
-        result->append(doc.toPlainText());
-    } while (epub_it_get_next(iter));
+    QHash<QString, QString> manifest;
+    QStringList spine;
+    QStringList guide;
+    QString tocId;
+    QString ncxPath;
 
-    epub_free_iterator(iter);
+    bool hasTitle = false;
+    bool hasDate = false;
 
-    struct titerator* tit;
+    // The package document is small, it is read in a single streaming pass
+    QXmlStreamReader xml(zip.data(opfPath));
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement())
+            continue;
 
-    tit = epub_get_titerator(ePubDoc, TITERATOR_NAVMAP, 0);
-    if (!tit) {
-        tit = epub_get_titerator(ePubDoc, TITERATOR_GUIDE, 0);
+        const QStringRef name = xml.name();
+        const QXmlStreamAttributes attributes = xml.attributes();
+
+        if (xml.namespaceUri() == QLatin1String(dcNamespace)) {
+            const QString elementName = name.toString();
+            const QString value = xml.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
+            if (value.isEmpty())
+                continue;
+
+            if (elementName == QLatin1String("title")) {
+                if (!hasTitle)
+                    result->add(Property::Title, value);
+                hasTitle = true;
+            } else if (elementName == QLatin1String("subject")) {
+                result->add(Property::Subject, value);
+            } else if (elementName == QLatin1String("creator")) {
+                // Illustrators, editors and so on are also creators
+                const QString role = attributeValue(attributes, "role");
+                if (!role.isEmpty() && role != QLatin1String("aut"))
+                    continue;
+
+                // A lot of authors have their name written in () again. We discard that part
+                QString author = value;
+                const int index = author.indexOf(QLatin1Char('('));
+                if (index > 0)
+                    author = author.left(index).trimmed();
+
+                result->add(Property::Creator, author);
+            } else if (elementName == QLatin1String("publisher")) {
+                result->add(Property::Publisher, value);
+            } else if (elementName == QLatin1String("description")) {
+                // Descriptions are often copied from a web page, with their markup
+                const QString description = MarkupStripper::toPlainText(value);
+                if (!description.isEmpty())
+                    result->add(Property::Description, description);
+            } else if (elementName == QLatin1String("date")) {
+                const QString event = attributeValue(attributes, "event");
+                if (hasDate || (!event.isEmpty() && event != QLatin1String("publication")))
+                    continue;
+
+                const QDateTime dt = ExtractorPlugin::dateTimeFromString(value);
+                if (!dt.isNull()) {
+                    result->add(Property::CreationDate, dt);
+                    hasDate = true;
+                }
+            }
+        } else if (name == QLatin1String("item")) {
+            const QString id = attributes.value(QLatin1String("id")).toString();
+            const QString path = resolvePath(opfDirectory, attributes.value(QLatin1String("href")).toString());
+            manifest.insert(id, path);
+
+            if (attributes.value(QLatin1String("media-type")) == QLatin1String("application/x-dtbncx+xml"))
+                ncxPath = path;
+        } else if (name == QLatin1String("spine")) {
+            tocId = attributes.value(QLatin1String("toc")).toString();
+        } else if (name == QLatin1String("itemref")) {
+            spine << attributes.value(QLatin1String("idref")).toString();
+        } else if (name == QLatin1String("reference")) {
+            const QString path = resolvePath(opfDirectory, attributes.value(QLatin1String("href")).toString());
+            if (!path.isEmpty())
+                guide << path;
+        }
     }
 
-    if (epub_tit_curr_valid(tit)) {
-        do {
-            char* clink = epub_tit_get_curr_link(tit);
+    // Only the package document is needed for the metadata
+    if (!(result->inputFlags() & ExtractionResult::ExtractPlainText))
+        return;
 
-            char* data;
-            int size = epub_get_data(ePubDoc, clink, &data);
-            free(clink);
+    //
+    // Plain Text
+    //
+    // Every content document is only read once, in the order of the spine.
+    // Documents which are only linked from the navigation map, or from the
+    // guide of books without one, come last.
+    QStringList chapters;
+    QSet<QString> seen;
+    foreach (const QString& id, spine) {
+        const QString path = manifest.value(id);
+        if (!path.isEmpty() && !seen.contains(path)) {
+            seen.insert(path);
+            chapters << path;
+        }
+    }
 
-            // epub_get_data returns -1 on failure
-            if (size > 0 && data) {
-                QString html = QString::fromUtf8(data, size);
+    if (!tocId.isEmpty() && manifest.contains(tocId))
+        ncxPath = manifest.value(tocId);
 
-                QTextDocument doc;
-                doc.setHtml(html);
-                result->append(doc.toPlainText());
-                free(data);
-            }
-        } while (epub_tit_next(tit));
+    QStringList links;
+    if (!ncxPath.isEmpty())
+        links = readNavigationMap(zip, ncxPath);
+    if (links.isEmpty())
+        links = guide;
+
+    foreach (const QString& path, links) {
+        if (!seen.contains(path)) {
+            seen.insert(path);
+            chapters << path;
+        }
     }
-    epub_free_titerator(tit);
+
+    // The chapters are inflated while they are converted
+    extractParts(chapters, ChapterConverter(zip), result);
 }
 
 KFILEMETADATA_EXPORT_EXTRACTOR(KFileMetaData::EPubExtractor, "kfilemetadata_epubextractor")
@@ -19,6 +19,7 @@
 
 
 #include "exiv2extractor.h"
+#include "xmpreader.h"
 
 #include <KDebug>
 
@@ -118,6 +119,50 @@ QVariant toVariantString(const Exiv2::Value& value)
     return QVariant();
 }
 
+/**
+ * Returns the XMP data which readMetadata() has decoded in the form of
+ * the shared reader, so that the packet is not parsed a second time
+ */
+XmpReader toXmpReader(const Exiv2::XmpData& data)
+{
+    XmpReader xmp;
+    for (Exiv2::XmpData::const_iterator it = data.begin(); it != data.end(); ++it) {
+        // Unknown prefixes have no namespace
+        std::string namespaceUri;
+        try {
+            namespaceUri = Exiv2::XmpProperties::ns(it->groupName());
+        } catch (const std::exception&) {
+            continue;
+        }
+
+        const Exiv2::Value& value = it->value();
+
+        QStringList values;
+        if (value.typeId() == Exiv2::langAlt) {
+            const Exiv2::LangAltValue& alternatives = static_cast<const Exiv2::LangAltValue&>(value);
+            Exiv2::LangAltValue::ValueType::const_iterator alternative = alternatives.value_.find("x-default");
+            if (alternative == alternatives.value_.end())
+                alternative = alternatives.value_.begin();
+            if (alternative != alternatives.value_.end())
+                values << QString::fromUtf8(alternative->second.c_str(), alternative->second.length());
+        } else if (value.typeId() == Exiv2::xmpBag || value.typeId() == Exiv2::xmpSeq
+                   || value.typeId() == Exiv2::xmpAlt) {
+            for (long i = 0; i < long(value.count()); i++) {
+                const std::string str = value.toString(i);
+                values << QString::fromUtf8(str.c_str(), str.length());
+            }
+        } else {
+            values << toString(value);
+        }
+
+        const std::string tagName = it->tagName();
+        xmp.addValues(QString::fromUtf8(namespaceUri.c_str(), namespaceUri.length()),
+                      QString::fromUtf8(tagName.c_str(), tagName.length()), values);
+    }
+
+    return xmp;
+}
+
 QVariant toVariant(const Exiv2::Value& value, QVariant::Type type) {
     if (value.count() == 0) {
         return QVariant();
@@ -178,33 +223,41 @@ void Exiv2Extractor::extract(ExtractionResult* result)
         result->add(Property::Comment, QString::fromUtf8(comment.c_str(), comment.length()));
     }
 
+    // Images and PDFs map the XMP properties in the same way. Its values take
+    // precedence over the Exif ones.
+    const XmpReader xmp = toXmpReader(image->xmpData());
+    xmp.addProperties(result);
+
     const Exiv2::ExifData& data = image->exifData();
 
-    add(result, data, Property::ImageMake, "Exif.Image.Make", QVariant::String);
-    add(result, data, Property::ImageModel, "Exif.Image.Model", QVariant::String);
-    add(result, data, Property::ImageDateTime, "Exif.Image.DateTime", QVariant::DateTime);
-    add(result, data, Property::ImageOrientation, "Exif.Image.Orientation", QVariant::Int);
-    add(result, data, Property::PhotoFlash, "Exif.Photo.Flash", QVariant::Int);
-    add(result, data, Property::PhotoPixelXDimension, "Exif.Photo.PixelXDimension", QVariant::Int);
-    add(result, data, Property::PhotoPixelYDimension, "Exif.Photo.PixelYDimension", QVariant::Int);
-    add(result, data, Property::PhotoDateTimeOriginal, "Exif.Photo.DateTimeOriginal", QVariant::DateTime);
-    add(result, data, Property::PhotoFocalLength, "Exif.Photo.FocalLength", QVariant::Double);
-    add(result, data, Property::PhotoFocalLengthIn35mmFilm, "Exif.Photo.FocalLengthIn35mmFilm", QVariant::Double);
-    add(result, data, Property::PhotoExposureTime, "Exif.Photo.ExposureTime", QVariant::Double);
-    add(result, data, Property::PhotoExposureBiasValue, "Exif.Photo.ExposureBiasValue", QVariant::Double);
-    add(result, data, Property::PhotoFNumber, "Exif.Photo.FNumber", QVariant::Double);
-    add(result, data, Property::PhotoApertureValue, "Exif.Photo.ApertureValue", QVariant::Double);
-    add(result, data, Property::PhotoWhiteBalance, "Exif.Photo.WhiteBalance", QVariant::Int);
-    add(result, data, Property::PhotoMeteringMode, "Exif.Photo.MeteringMode", QVariant::Int);
-    add(result, data, Property::PhotoISOSpeedRatings, "Exif.Photo.ISOSpeedRatings", QVariant::Int);
-    add(result, data, Property::PhotoSaturation, "Exif.Photo.Saturation", QVariant::Int);
-    add(result, data, Property::PhotoSharpness, "Exif.Photo.Sharpness", QVariant::Int);
+    add(result, data, xmp, Property::ImageMake, "Exif.Image.Make", QVariant::String);
+    add(result, data, xmp, Property::ImageModel, "Exif.Image.Model", QVariant::String);
+    add(result, data, xmp, Property::ImageDateTime, "Exif.Image.DateTime", QVariant::DateTime);
+    add(result, data, xmp, Property::ImageOrientation, "Exif.Image.Orientation", QVariant::Int);
+    add(result, data, xmp, Property::PhotoFlash, "Exif.Photo.Flash", QVariant::Int);
+    add(result, data, xmp, Property::PhotoPixelXDimension, "Exif.Photo.PixelXDimension", QVariant::Int);
+    add(result, data, xmp, Property::PhotoPixelYDimension, "Exif.Photo.PixelYDimension", QVariant::Int);
+    add(result, data, xmp, Property::PhotoDateTimeOriginal, "Exif.Photo.DateTimeOriginal", QVariant::DateTime);
+    add(result, data, xmp, Property::PhotoFocalLength, "Exif.Photo.FocalLength", QVariant::Double);
+    add(result, data, xmp, Property::PhotoFocalLengthIn35mmFilm, "Exif.Photo.FocalLengthIn35mmFilm", QVariant::Double);
+    add(result, data, xmp, Property::PhotoExposureTime, "Exif.Photo.ExposureTime", QVariant::Double);
+    add(result, data, xmp, Property::PhotoExposureBiasValue, "Exif.Photo.ExposureBiasValue", QVariant::Double);
+    add(result, data, xmp, Property::PhotoFNumber, "Exif.Photo.FNumber", QVariant::Double);
+    add(result, data, xmp, Property::PhotoApertureValue, "Exif.Photo.ApertureValue", QVariant::Double);
+    add(result, data, xmp, Property::PhotoWhiteBalance, "Exif.Photo.WhiteBalance", QVariant::Int);
+    add(result, data, xmp, Property::PhotoMeteringMode, "Exif.Photo.MeteringMode", QVariant::Int);
+    add(result, data, xmp, Property::PhotoISOSpeedRatings, "Exif.Photo.ISOSpeedRatings", QVariant::Int);
+    add(result, data, xmp, Property::PhotoSaturation, "Exif.Photo.Saturation", QVariant::Int);
+    add(result, data, xmp, Property::PhotoSharpness, "Exif.Photo.Sharpness", QVariant::Int);
 }
 
 void Exiv2Extractor::add(ExtractionResult* result, const Exiv2::ExifData& data,
-                         Property::Property prop, const char* name,
+                         const XmpReader& xmp, Property::Property prop, const char* name,
                          QVariant::Type type)
 {
+    if (xmp.contains(prop))
+        return;
+
     Exiv2::ExifData::const_iterator it = data.findKey(Exiv2::ExifKey(name));
     if (it != data.end()) {
         QVariant value = toVariant(it->value(), type);
@@ -27,6 +27,8 @@
 namespace KFileMetaData
 {
 
+class XmpReader;
+
 class Exiv2Extractor : public ExtractorPlugin
 {
 public:
@@ -37,7 +39,7 @@ public:
 
 private:
     void add(ExtractionResult* result, const Exiv2::ExifData& data,
-             Property::Property prop,
+             const XmpReader& xmp, Property::Property prop,
              const char* name, QVariant::Type type);
 };
 }
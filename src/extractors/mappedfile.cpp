@@ -0,0 +1,74 @@
+/*
+    Read only access to a memory mapped file
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "mappedfile.h"
+
+using namespace KFileMetaData;
+
+MappedFile::MappedFile(const QString& fileName, bool allowMapping)
+    : m_file(fileName)
+    , m_data(0)
+    , m_size(0)
+    , m_mapped(false)
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+
+    const qint64 size = m_file.size();
+    if (size <= 0)
+        return;
+
+    if (allowMapping)
+        m_data = m_file.map(0, size);
+
+    if (m_data) {
+        m_mapped = true;
+    } else {
+        // Some file systems cannot be mapped
+        m_buffer = m_file.readAll();
+        if (m_buffer.size() != size) {
+            m_buffer.clear();
+            return;
+        }
+        m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    }
+
+    m_size = size;
+}
+
+bool MappedFile::isValid() const
+{
+    return m_data != 0;
+}
+
+bool MappedFile::isMapped() const
+{
+    return m_mapped;
+}
+
+const uchar* MappedFile::data() const
+{
+    return m_data;
+}
+
+qint64 MappedFile::size() const
+{
+    return m_size;
+}
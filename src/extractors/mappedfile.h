@@ -0,0 +1,71 @@
+/*
+    Read only access to a memory mapped file
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+namespace KFileMetaData
+{
+
+/**
+ * \class MappedFile mappedfile.h
+ *
+ * \brief Read only access to all the data of a file, which is memory
+ * mapped when possible.
+ *
+ * Some file systems cannot be mapped, the file is read into memory then.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Opens \p fileName. With \p allowMapping set to false the file is
+     * always read into memory, eg - to test that fallback.
+     */
+    explicit MappedFile(const QString& fileName, bool allowMapping = true);
+
+    /**
+     * Returns true if all the data of the file is available
+     */
+    bool isValid() const;
+
+    /**
+     * Returns true if the data is memory mapped instead of read
+     */
+    bool isMapped() const;
+
+    const uchar* data() const;
+    qint64 size() const;
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    const uchar* m_data;
+    qint64 m_size;
+    bool m_mapped;
+};
+
+}
+
+#endif // MAPPED_FILE_H
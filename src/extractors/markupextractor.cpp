@@ -0,0 +1,85 @@
+/*
+    Text and title extraction for HTML and XML files
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "markupextractor.h"
+#include "markupstripper.h"
+
+#include <QFile>
+
+using namespace KFileMetaData;
+
+MarkupExtractor::MarkupExtractor(QObject* parent, const QVariantList&)
+    : ExtractorPlugin(parent)
+{
+
+}
+
+QStringList MarkupExtractor::mimetypes() const
+{
+    QStringList list;
+    list << QLatin1String("text/html")
+         << QLatin1String("application/xhtml+xml")
+         << QLatin1String("text/xml")
+         << QLatin1String("application/xml")
+         << QLatin1String("image/svg+xml");
+
+    return list;
+}
+
+void MarkupExtractor::extract(ExtractionResult* result)
+{
+    QFile file(result->inputUrl());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const QString mimeType = result->inputMimetype();
+    const bool isHtml = mimeType == QLatin1String("text/html") ||
+                        mimeType == QLatin1String("application/xhtml+xml");
+
+    MarkupStripper stripper(isHtml ? MarkupStripper::Html : MarkupStripper::Xml);
+
+    QByteArray buffer;
+    buffer.resize(64 * 1024);
+
+    qint64 size;
+    while ((size = file.read(buffer.data(), buffer.size())) > 0) {
+        const QString text = stripper.process(buffer.constData(), size);
+        if (!text.isEmpty())
+            result->append(text);
+    }
+
+    const QString text = stripper.finish();
+    if (!text.isEmpty())
+        result->append(text);
+
+    if (isHtml) {
+        const QString title = stripper.title();
+        if (!title.isEmpty())
+            result->add(Property::Title, title);
+    }
+
+    if (mimeType == QLatin1String("image/svg+xml"))
+        result->addType(Type::Image);
+    else
+        result->addType(Type::Text);
+}
+
+KFILEMETADATA_EXPORT_EXTRACTOR(KFileMetaData::MarkupExtractor, "kfilemetadata_markupextractor")
@@ -0,0 +1,414 @@
+/*
+    Single pass conversion of HTML and XML markup to plain text
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "markupstripper.h"
+#include "extractionresult.h"
+#include "utf8text.h"
+
+#include <string.h>
+
+using namespace KFileMetaData;
+
+namespace
+{
+// Longest entity name we try to decode, such as "#x10FFFF"
+const int maxEntitySize = 10;
+
+const char* const blockElements[] = {
+    "address", "article", "aside", "blockquote", "br", "caption", "dd", "div",
+    "dl", "dt", "figcaption", "figure", "footer", "form", "h1", "h2", "h3",
+    "h4", "h5", "h6", "header", "hr", "li", "nav", "ol", "p", "pre", "section",
+    "table", "title", "tr", "ul", 0
+};
+
+struct NamedEntity {
+    const char* name;
+    uint codePoint;
+};
+
+const NamedEntity namedEntities[] = {
+    { "nbsp", 0xA0 }, { "shy", 0xAD }, { "copy", 0xA9 }, { "reg", 0xAE }, { "trade", 0x2122 },
+    { "hellip", 0x2026 }, { "mdash", 0x2014 }, { "ndash", 0x2013 }, { "lsquo", 0x2018 },
+    { "rsquo", 0x2019 }, { "ldquo", 0x201C }, { "rdquo", 0x201D }, { "laquo", 0xAB },
+    { "raquo", 0xBB }, { "bull", 0x2022 }, { "middot", 0xB7 }, { "deg", 0xB0 },
+    { "sect", 0xA7 }, { "times", 0xD7 }, { "euro", 0x20AC }, { "pound", 0xA3 },
+    { "cent", 0xA2 }, { "yen", 0xA5 }, { "auml", 0xE4 }, { "ouml", 0xF6 },
+    { "uuml", 0xFC }, { "Auml", 0xC4 }, { "Ouml", 0xD6 }, { "Uuml", 0xDC },
+    { "szlig", 0xDF }, { "eacute", 0xE9 }, { "egrave", 0xE8 }, { "agrave", 0xE0 },
+    { "ccedil", 0xE7 }, { 0, 0 }
+};
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f';
+}
+
+inline bool isNameChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+           || c == ':' || c == '-' || c == '_' || c == '.';
+}
+
+inline char toLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+bool isBlockElement(const QByteArray& name)
+{
+    for (int i = 0; blockElements[i]; i++) {
+        if (name == blockElements[i])
+            return true;
+    }
+    return false;
+}
+}
+
+MarkupStripper::MarkupStripper(Mode mode, TitleHandling titleHandling)
+    : m_mode(mode)
+    , m_titleHandling(titleHandling)
+    , m_state(Text)
+    , m_quote(0)
+    , m_closingTag(false)
+    , m_selfClosing(false)
+    , m_inTitle(false)
+    , m_matched(0)
+{
+}
+
+QString MarkupStripper::process(const char* data, int length)
+{
+    for (int i = 0; i < length; i++) {
+        const char c = data[i];
+
+        switch (m_state) {
+        case Text:
+            if (c == '<') {
+                m_state = TagOpen;
+            } else if (c == '&') {
+                m_entity.clear();
+                m_state = Entity;
+            } else {
+                appendText(c);
+            }
+            break;
+
+        case TagOpen:
+            m_closingTag = false;
+            m_selfClosing = false;
+            m_tagName.clear();
+
+            if (c == '/') {
+                m_closingTag = true;
+                m_state = TagName;
+            } else if (c == '!') {
+                m_markup.clear();
+                m_state = Declaration;
+            } else if (c == '?') {
+                m_markup.clear();
+                m_state = Declaration;
+            } else if (isNameChar(c)) {
+                m_tagName.append(toLower(c));
+                m_state = TagName;
+            } else {
+                // Not a tag, just a stray '<'
+                appendText('<');
+                m_state = Text;
+                i--;
+            }
+            break;
+
+        case TagName:
+            if (isNameChar(c)) {
+                if (m_tagName.size() < 32)
+                    m_tagName.append(toLower(c));
+            } else {
+                m_state = Tag;
+                i--;
+            }
+            break;
+
+        case Tag:
+            if (c == '>') {
+                endTag();
+            } else if (c == '"' || c == '\'') {
+                m_quote = c;
+                m_state = TagQuoted;
+            } else if (c == '/') {
+                m_selfClosing = true;
+            } else if (!isSpace(c)) {
+                m_selfClosing = false;
+            }
+            break;
+
+        case TagQuoted:
+            if (c == m_quote)
+                m_state = Tag;
+            break;
+
+        case Declaration:
+            if (c == '>') {
+                m_state = Text;
+                if (m_mode == Xml)
+                    appendSpace();
+                break;
+            }
+
+            if (m_markup.size() < 7) {
+                m_markup.append(c);
+                if (m_markup == "--") {
+                    m_matched = 0;
+                    m_state = Comment;
+                } else if (m_markup == "[CDATA[") {
+                    m_matched = 0;
+                    m_state = CData;
+                }
+            }
+            break;
+
+        case Comment:
+            if (c == '-') {
+                m_matched++;
+            } else if (c == '>' && m_matched >= 2) {
+                m_state = Text;
+            } else {
+                m_matched = 0;
+            }
+            break;
+
+        case CData:
+            if (c == ']') {
+                if (m_matched == 2)
+                    appendText(']');
+                else
+                    m_matched++;
+            } else if (c == '>' && m_matched == 2) {
+                m_state = Text;
+            } else {
+                for (; m_matched > 0; m_matched--)
+                    appendText(']');
+                appendText(c);
+            }
+            break;
+
+        case Entity:
+            if (c == ';') {
+                appendEntity();
+                m_state = Text;
+            } else if ((isNameChar(c) || c == '#') && m_entity.size() < maxEntitySize) {
+                m_entity.append(c);
+            } else {
+                // Not an entity, keep it as it is
+                appendText('&');
+                for (int j = 0; j < m_entity.size(); j++)
+                    appendText(m_entity[j]);
+                m_state = Text;
+                i--;
+            }
+            break;
+
+        case RawText: {
+            // Skip everything until the matching end tag
+            const char* next = static_cast<const char*>(memchr(data + i, '<', length - i));
+            if (m_matched == 0) {
+                if (!next) {
+                    i = length;
+                    break;
+                }
+                i = next - data;
+            }
+
+            if (toLower(data[i]) == m_rawTextEnd[m_matched]) {
+                m_matched++;
+                if (m_matched == m_rawTextEnd.size()) {
+                    m_tagName = m_rawTextEnd.mid(2);
+                    m_closingTag = true;
+                    m_selfClosing = false;
+                    m_state = Tag;
+                }
+            } else {
+                m_matched = (data[i] == '<') ? 1 : 0;
+            }
+            break;
+        }
+        }
+    }
+
+    return takeCompleteWords(m_text, false);
+}
+
+QString MarkupStripper::finish()
+{
+    if (m_state == TagOpen) {
+        appendText('<');
+    } else if (m_state == Entity) {
+        appendText('&');
+        for (int j = 0; j < m_entity.size(); j++)
+            appendText(m_entity[j]);
+    }
+
+    m_state = Text;
+    m_inTitle = false;
+    m_matched = 0;
+
+    return takeCompleteWords(m_text, true);
+}
+
+void MarkupStripper::strip(const char* data, qint64 length, ExtractionResult* result)
+{
+    // The text is handed on in pieces instead of all at the end
+    const int chunkSize = 64 * 1024;
+
+    for (qint64 offset = 0; offset < length; offset += chunkSize) {
+        const QString text = process(data + offset, qMin<qint64>(chunkSize, length - offset));
+        if (!text.isEmpty())
+            result->append(text);
+    }
+
+    const QString text = finish();
+    if (!text.isEmpty())
+        result->append(text);
+}
+
+QString MarkupStripper::toPlainText(const QString& html)
+{
+    const QByteArray data = html.toUtf8();
+
+    MarkupStripper stripper;
+    QString text = stripper.process(data.constData(), data.size());
+    const QString rest = stripper.finish();
+    if (!text.isEmpty() && !rest.isEmpty())
+        text += QLatin1Char(' ');
+
+    return text + rest;
+}
+
+QString MarkupStripper::title() const
+{
+    return QString::fromUtf8(m_title.constData(), m_title.size()).simplified();
+}
+
+void MarkupStripper::endTag()
+{
+    m_state = Text;
+
+    if (!m_closingTag && !m_selfClosing &&
+            (m_tagName == "script" || m_tagName == "style")) {
+        m_rawTextEnd = "</" + m_tagName;
+        m_matched = 0;
+        m_state = RawText;
+        return;
+    }
+
+    if (m_mode == Xml) {
+        appendSpace();
+        return;
+    }
+
+    if (m_tagName == "title" && !m_selfClosing) {
+        m_inTitle = !m_closingTag;
+    }
+
+    if (isBlockElement(m_tagName)) {
+        appendNewLine();
+    } else if (m_tagName == "td" || m_tagName == "th" || m_tagName == "img") {
+        appendSpace();
+    }
+}
+
+void MarkupStripper::appendText(char c)
+{
+    if (isSpace(c)) {
+        appendSpace();
+        return;
+    }
+
+    if (m_inTitle) {
+        m_title.append(c);
+        if (m_titleHandling == ExcludeTitle)
+            return;
+    }
+
+    m_text.append(c);
+}
+
+void MarkupStripper::appendSpace()
+{
+    if (m_inTitle) {
+        if (!m_title.isEmpty())
+            m_title.append(' ');
+        if (m_titleHandling == ExcludeTitle)
+            return;
+    }
+
+    if (!m_text.isEmpty()) {
+        const char last = m_text.at(m_text.size() - 1);
+        if (last != ' ' && last != '\n')
+            m_text.append(' ');
+    }
+}
+
+void MarkupStripper::appendNewLine()
+{
+    if (m_text.isEmpty())
+        return;
+
+    const int last = m_text.size() - 1;
+    if (m_text.at(last) == ' ')
+        m_text[last] = '\n';
+    else if (m_text.at(last) != '\n')
+        m_text.append('\n');
+}
+
+void MarkupStripper::appendEntity()
+{
+    uint codePoint = 0;
+    bool ok = decodeCharacterReference(m_entity, &codePoint);
+
+    // HTML knows many more names than XML
+    for (int i = 0; !ok && namedEntities[i].name; i++) {
+        if (m_entity == namedEntities[i].name) {
+            codePoint = namedEntities[i].codePoint;
+            ok = true;
+        }
+    }
+
+    if (!ok) {
+        appendText('&');
+        for (int j = 0; j < m_entity.size(); j++)
+            appendText(m_entity[j]);
+        appendText(';');
+        return;
+    }
+
+    // Soft hyphens are only hints for line breaking
+    if (codePoint == 0xAD)
+        return;
+
+    if (codePoint == 0xA0) {
+        appendSpace();
+        return;
+    }
+
+    QByteArray utf8;
+    appendUtf8(utf8, codePoint);
+    for (int j = 0; j < utf8.size(); j++)
+        appendText(utf8[j]);
+}
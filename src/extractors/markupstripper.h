@@ -0,0 +1,135 @@
+/*
+    Single pass conversion of HTML and XML markup to plain text
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef MARKUPSTRIPPER_H
+#define MARKUPSTRIPPER_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace KFileMetaData
+{
+
+class ExtractionResult;
+
+/**
+ * \class MarkupStripper markupstripper.h
+ *
+ * \brief Converts HTML or XML markup into plain text in a single pass.
+ *
+ * The markup is fed in chunks of UTF-8 encoded data and can be split at
+ * any byte. Tags and comments are dropped, the contents of script and
+ * style elements are skipped and character references are decoded.
+ * Whitespace is collapsed, and in Html mode block level elements are
+ * separated by newlines.
+ *
+ * No document tree is built, the only allocation is the output buffer.
+ */
+class MarkupStripper
+{
+public:
+    enum Mode {
+        /// Inline elements such as <b> do not separate words
+        Html,
+        /// Every tag separates words
+        Xml
+    };
+
+    enum TitleHandling {
+        /// The contents of <title> are part of the text, as for web pages
+        IncludeTitle,
+        /// The contents of <title> are only returned by title(), eg - for
+        /// the chapters of a book, which repeat the title of the book
+        ExcludeTitle
+    };
+
+    explicit MarkupStripper(Mode mode = Html, TitleHandling titleHandling = IncludeTitle);
+
+    /**
+     * Processes the next \p length bytes of markup and returns the text
+     * which is complete so far. Text is only returned up to a word
+     * boundary, the rest is returned by a later call or by finish().
+     */
+    QString process(const char* data, int length);
+
+    /**
+     * Returns the remaining text once all the markup has been processed
+     */
+    QString finish();
+
+    /**
+     * Convenience function which converts the \p length bytes of markup at
+     * \p data and appends the text to \p result
+     */
+    void strip(const char* data, qint64 length, ExtractionResult* result);
+
+    /**
+     * Convenience function which returns the text of a short piece of
+     * \p html, eg - a description
+     */
+    static QString toPlainText(const QString& html);
+
+    /**
+     * The contents of the <title> element, if one has been seen
+     */
+    QString title() const;
+
+private:
+    enum State {
+        Text,
+        TagOpen,
+        TagName,
+        Tag,
+        TagQuoted,
+        Declaration,
+        Comment,
+        CData,
+        Entity,
+        RawText
+    };
+
+    void endTag();
+    void appendText(char c);
+    void appendSpace();
+    void appendNewLine();
+    void appendEntity();
+
+    Mode m_mode;
+    TitleHandling m_titleHandling;
+    State m_state;
+
+    QByteArray m_text;
+    QByteArray m_title;
+
+    QByteArray m_tagName;
+    QByteArray m_rawTextEnd;
+    QByteArray m_entity;
+    QByteArray m_markup;
+
+    char m_quote;
+    bool m_closingTag;
+    bool m_selfClosing;
+    bool m_inTitle;
+    int m_matched;
+};
+
+}
+
+#endif // MARKUPSTRIPPER_H
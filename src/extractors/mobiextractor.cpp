@@ -21,13 +21,13 @@
 
 
 #include "mobiextractor.h"
+#include "markupstripper.h"
 
 #include <qmobipocket/mobipocket.h>
 
 #include <KDebug>
 #include <QDateTime>
 #include <QFile>
-#include <QTextDocument>
 
 using namespace KFileMetaData;
 
@@ -80,12 +80,9 @@ void MobiExtractor::extract(ExtractionResult* result)
             break;
         }
         case Mobipocket::Document::Description: {
-            QTextDocument document;
-            document.setHtml(it.value());
-
-            QString plain = document.toPlainText();
+            const QString plain = MarkupStripper::toPlainText(it.value());
             if (!plain.isEmpty())
-                result->add(Property::Description, it.value());
+                result->add(Property::Description, plain);
             break;
         }
         case Mobipocket::Document::Subject:
@@ -98,12 +95,11 @@ void MobiExtractor::extract(ExtractionResult* result)
     }
 
     if (!doc.hasDRM()) {
-        QString html = doc.text();
-
-        QTextDocument document;
-        document.setHtml(html);
+        const QByteArray html = doc.text().toUtf8();
 
-        result->append(document.toPlainText());
+        // The title of the book is already a property
+        MarkupStripper stripper(MarkupStripper::Html, MarkupStripper::ExcludeTitle);
+        stripper.strip(html.constData(), html.size(), result);
     }
 
     result->addType(Type::Document);
@@ -20,15 +20,68 @@
 
 
 #include "odfextractor.h"
+#include "mappedfile.h"
+#include "xmlmetadatareader.h"
+#include "xmltextscanner.h"
+#include "zipcontainer.h"
 
 #include <KDebug>
-#include <KZip>
 
-#include <QDomDocument>
-#include <QXmlStreamReader>
+#include <QScopedPointer>
 
 using namespace KFileMetaData;
 
+namespace
+{
+// The metadata of a flat document is only looked for in this many bytes at its start
+const int maxFlatMetaSize = 1024 * 1024;
+
+const XmlMetaDataElement metaElements[] = {
+    // Dublin Core
+    { "dc:description", 0, Property::Description, XmlMetaDataElement::Text },
+    { "dc:subject", 0, Property::Subject, XmlMetaDataElement::Text },
+    { "dc:title", 0, Property::Title, XmlMetaDataElement::Text },
+    { "dc:creator", 0, Property::Creator, XmlMetaDataElement::Text },
+    { "dc:language", 0, Property::Langauge, XmlMetaDataElement::Text },
+
+    // Meta Properties
+    { "meta:document-statistic", "meta:page-count", Property::PageCount, XmlMetaDataElement::Integer },
+    { "meta:document-statistic", "meta:word-count", Property::WordCount, XmlMetaDataElement::Integer },
+    { "meta:keyword", 0, Property::Keywords, XmlMetaDataElement::Text },
+    { "meta:generator", 0, Property::Creator, XmlMetaDataElement::Text },
+    { "meta:creation-date", 0, Property::CreationDate, XmlMetaDataElement::DateTime }
+};
+
+void setupContentScanner(XmlTextScanner& scanner)
+{
+    // All the text is in paragraphs and headings, possibly nested in lists, tables or frames
+    scanner.addTextElement("text:p");
+    scanner.addTextElement("text:h");
+    scanner.addSeparator("text:p", '\n');
+    scanner.addSeparator("text:h", '\n');
+
+    // Runs of spaces, tabs and line breaks are elements of their own
+    scanner.addSeparator("text:s", ' ');
+    scanner.addSeparator("text:tab", '\t');
+    scanner.addSeparator("text:line-break", '\n');
+
+    // Styles, scripts and forms never contain any text of the document, and
+    // neither do deleted changes or the numbers of notes
+    scanner.addSkippedElement("office:font-face-decls");
+    scanner.addSkippedElement("office:automatic-styles");
+    scanner.addSkippedElement("office:styles");
+    scanner.addSkippedElement("office:master-styles");
+    scanner.addSkippedElement("office:settings");
+    scanner.addSkippedElement("office:scripts");
+    scanner.addSkippedElement("office:forms");
+    scanner.addSkippedElement("text:tracked-changes");
+    scanner.addSkippedElement("text:note-citation");
+
+    // Flat documents embed their images as base64 in the frames of paragraphs
+    scanner.addSkippedElement("office:binary-data");
+}
+}
+
 OdfExtractor::OdfExtractor(QObject* parent, const QVariantList&): ExtractorPlugin(parent)
 {
 
@@ -39,100 +92,83 @@ QStringList OdfExtractor::mimetypes() const
     QStringList list;
     list << QLatin1String("application/vnd.oasis.opendocument.text")
          << QLatin1String("application/vnd.oasis.opendocument.presentation")
-         << QLatin1String("application/vnd.oasis.opendocument.spreadsheet");
+         << QLatin1String("application/vnd.oasis.opendocument.spreadsheet")
+         << QLatin1String("application/vnd.oasis.opendocument.text-flat-xml")
+         << QLatin1String("application/vnd.oasis.opendocument.presentation-flat-xml")
+         << QLatin1String("application/vnd.oasis.opendocument.spreadsheet-flat-xml");
 
     return list;
 }
 
 void OdfExtractor::extract(ExtractionResult* result)
 {
-    KZip zip(result->inputUrl());
-    if (!zip.open(QIODevice::ReadOnly)) {
-        qWarning() << "Document is not a valid ZIP archive";
+    if (result->inputMimetype().endsWith(QLatin1String("-flat-xml"))) {
+        extractFlat(result);
         return;
     }
 
-    const KArchiveDirectory* directory = zip.directory();
-    if (!directory) {
-        qWarning() << "Invalid document structure (main directory is missing)";
+    ZipContainer zip(result->inputUrl());
+    if (!zip.isValid()) {
+        qWarning() << "Document is not a valid ZIP archive";
         return;
     }
 
-    const QStringList entries = directory->entries();
-    if (!entries.contains("meta.xml")) {
+    if (!zip.contains(QLatin1String("meta.xml"))) {
         qWarning() << "Invalid document structure (meta.xml is missing)";
         return;
     }
 
-    QDomDocument metaData("metaData");
-    const KArchiveFile* file = static_cast<const KArchiveFile*>(directory->entry("meta.xml"));
-    metaData.setContent(file->data());
-
-    // parse metadata ...
-    QDomElement docElem = metaData.documentElement();
-
-    QDomNode n = docElem.firstChild().firstChild(); // <office:document-meta> ... <office:meta> ... content
-    while (!n.isNull()) {
-        QDomElement e = n.toElement();
-        if (!e.isNull()) {
-            const QString tagName = e.tagName();
-
-            // Dublin Core
-            if (tagName == QLatin1String("dc:description")) {
-                result->add(Property::Description, e.text());
-            } else if (tagName == QLatin1String("dc:subject")) {
-                result->add(Property::Subject, e.text());
-            } else if (tagName == QLatin1String("dc:title")) {
-                result->add(Property::Title, e.text());
-            } else if (tagName == QLatin1String("dc:creator")) {
-                result->add(Property::Creator, e.text());
-            } else if (tagName == QLatin1String("dc:langauge")) {
-                result->add(Property::Langauge, e.text());
-            }
-
-            // Meta Properties
-            else if (tagName == QLatin1String("meta:document-statistic")) {
-                bool ok = false;
-                int pageCount = e.attribute("meta:page-count").toInt(&ok);
-                if (ok) {
-                    result->add(Property::PageCount, pageCount);
-                }
-
-                int wordCount = e.attribute("meta:word-count").toInt(&ok);
-                if (ok) {
-                    result->add(Property::WordCount, wordCount);
-                }
-            } else if (tagName == QLatin1String("meta:keyword")) {
-                QString keywords = e.text();
-                    result->add(Property::Keywords, keywords);
-            } else if (tagName == QLatin1String("meta:generator")) {
-                result->add(Property::Creator, e.text());
-            } else if (tagName == QLatin1String("meta:creation-date")) {
-                QDateTime dt = ExtractorPlugin::dateTimeFromString(e.text());
-                if (!dt.isNull())
-                    result->add(Property::CreationDate, dt);
-            }
-        }
-        n = n.nextSibling();
+    readXmlMetaData(zip.data(QLatin1String("meta.xml")), metaElements,
+                    sizeof(metaElements) / sizeof(metaElements[0]), result);
+
+    result->addType(Type::Document);
+
+    // Only meta.xml is read when the text is not needed
+    if (!(result->inputFlags() & ExtractionResult::ExtractPlainText))
+        return;
+
+    QScopedPointer<QIODevice> contentsDevice(zip.device(QLatin1String("content.xml")));
+    if (!contentsDevice) {
+        qWarning() << "Invalid document structure (content.xml is missing)";
+        return;
     }
 
-    const KArchiveFile* contentsFile = static_cast<const KArchiveFile*>(directory->entry("content.xml"));
-    QXmlStreamReader xml(contentsFile->createDevice());
+    XmlTextScanner scanner;
+    setupContentScanner(scanner);
+    scanner.scan(contentsDevice.data(), result);
 
-    while (!xml.atEnd()) {
-        xml.readNext();
-        if (xml.isCharacters()) {
-            QString str = xml.text().toString();
-            result->append(str);
-        }
+    return;
+}
 
-        if (xml.hasError() || xml.isEndDocument())
-            break;
+void OdfExtractor::extractFlat(ExtractionResult* result)
+{
+    // Flat documents are a single XML file with the same elements as the
+    // parts of a packaged one, the file is scanned where it is mapped
+    const MappedFile file(result->inputUrl());
+    if (!file.isValid()) {
+        qWarning() << "Could not read" << result->inputUrl();
+        return;
+    }
+
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const qint64 size = file.size();
+
+    // The metadata comes before the styles and the body, there is no need to parse those
+    const QByteArray head = QByteArray::fromRawData(data, qMin<qint64>(size, maxFlatMetaSize));
+    const int metaEnd = head.indexOf("</office:meta>");
+    if (metaEnd != -1) {
+        readXmlMetaData(QByteArray::fromRawData(data, metaEnd), metaElements,
+                        sizeof(metaElements) / sizeof(metaElements[0]), result);
     }
 
     result->addType(Type::Document);
 
-    return;
+    if (!(result->inputFlags() & ExtractionResult::ExtractPlainText))
+        return;
+
+    XmlTextScanner scanner;
+    setupContentScanner(scanner);
+    scanner.scan(data, size, result);
 }
 
 KFILEMETADATA_EXPORT_EXTRACTOR(KFileMetaData::OdfExtractor, "kfilemetadata_odfextractor")
@@ -35,6 +35,7 @@ public:
     virtual void extract(ExtractionResult* result);
 
 private:
+    void extractFlat(ExtractionResult* result);
 };
 }
 
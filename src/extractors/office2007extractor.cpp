@@ -19,189 +19,232 @@
 
 
 #include "office2007extractor.h"
+#include "partextraction.h"
+#include "xmlmetadatareader.h"
+#include "xmltextscanner.h"
+#include "zipcontainer.h"
 
 #include <KDebug>
-#include <KZip>
 
-#include <QDomDocument>
+#include <QDir>
+#include <QScopedPointer>
 #include <QXmlStreamReader>
 
 using namespace KFileMetaData;
 
-Office2007Extractor::Office2007Extractor(QObject* parent, const QVariantList&): ExtractorPlugin(parent)
+namespace
+{
+const XmlMetaDataElement coreElements[] = {
+    { "dc:description", 0, Property::Description, XmlMetaDataElement::Text },
+    { "dc:subject", 0, Property::Subject, XmlMetaDataElement::Text },
+    { "dc:title", 0, Property::Title, XmlMetaDataElement::Text },
+    { "dc:creator", 0, Property::Creator, XmlMetaDataElement::Text },
+    { "dc:language", 0, Property::Langauge, XmlMetaDataElement::Text },
+    { "cp:keywords", 0, Property::Keywords, XmlMetaDataElement::KeywordList },
+    { "dcterms:created", 0, Property::CreationDate, XmlMetaDataElement::DateTime }
+};
+
+// According to the ontologies only Documents can have a wordCount and pageCount
+const XmlMetaDataElement documentAppElements[] = {
+    { "Application", 0, Property::Generator, XmlMetaDataElement::Text },
+    { "Pages", 0, Property::PageCount, XmlMetaDataElement::Integer },
+    { "Words", 0, Property::WordCount, XmlMetaDataElement::Integer }
+};
+
+const XmlMetaDataElement appElements[] = {
+    { "Application", 0, Property::Generator, XmlMetaDataElement::Text }
+};
+
+bool containsDirectory(const ZipContainer& zip, const QString& directory)
+{
+    const QString prefix = directory + QLatin1Char('/');
+    foreach (const QString& name, zip.entries()) {
+        if (name.startsWith(prefix))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Reads the relationships of the part \p partName, and returns the
+ * full path of the targets keyed by their id. Only the relationships
+ * whose type ends with \p type are returned, eg - "/slide".
+ */
+QHash<QString, QString> readRelationships(ZipContainer& zip, const QString& partName, const QString& type)
 {
+    QHash<QString, QString> targets;
+
+    // The relationships of "ppt/presentation.xml" are in "ppt/_rels/presentation.xml.rels"
+    const int slash = partName.lastIndexOf(QLatin1Char('/'));
+    const QString directory = partName.left(slash + 1);
+    const QString relsName = directory + QLatin1String("_rels/") + partName.mid(slash + 1) + QLatin1String(".rels");
+
+    QXmlStreamReader xml(zip.data(relsName));
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement() && xml.name() == QLatin1String("Relationship")) {
+            const QXmlStreamAttributes attributes = xml.attributes();
+            if (!attributes.value(QLatin1String("Type")).toString().endsWith(type))
+                continue;
+
+            // Targets are relative to the directory of the part, unless they start with a '/'
+            const QString target = attributes.value(QLatin1String("Target")).toString();
+            const QString path = target.startsWith(QLatin1Char('/')) ? target.mid(1)
+                                                                      : QDir::cleanPath(directory + target);
+
+            targets.insert(attributes.value(QLatin1String("Id")).toString(), path);
+        }
+
+        if (xml.isEndDocument() || xml.hasError())
+            break;
+    }
 
+    return targets;
 }
 
+typedef void (*ScannerSetup)(XmlTextScanner& scanner);
 
-QStringList Office2007Extractor::mimetypes() const
+void setupDocumentScanner(XmlTextScanner& scanner)
 {
-    QStringList list;
-    list << QLatin1String("application/vnd.openxmlformats-officedocument.wordprocessingml.document")
-         << QLatin1String("application/vnd.openxmlformats-officedocument.presentationml.presentation")
-         << QLatin1String("application/vnd.openxmlformats-officedocument.spreadsheetml.sheet");
+    // Word splits a paragraph into many runs, their text is joined until the paragraph ends.
+    // The tab stops of the paragraph properties are also called w:tab, and are skipped.
+    scanner.addTextElement("w:t");
+    scanner.addSkippedElement("w:tabs");
+    scanner.addSeparator("w:p", '\n');
+    scanner.addSeparator("w:tab", '\t');
+    scanner.addSeparator("w:br", '\n');
+    scanner.addSeparator("w:cr", '\n');
+}
 
-    return list;
+void setupSlideScanner(XmlTextScanner& scanner)
+{
+    // Fields hold generated text such as slide numbers and dates
+    scanner.addTextElement("a:t");
+    scanner.addSkippedElement("a:fld");
+    scanner.addSeparator("a:p", '\n');
 }
 
-void Office2007Extractor::extract(ExtractionResult* result)
+void setupSharedStringsScanner(XmlTextScanner& scanner)
 {
-    KZip zip(result->inputUrl());
-    if (!zip.open(QIODevice::ReadOnly)) {
-        qWarning() << "Document is not a valid ZIP archive";
-        return;
-    }
+    // The phonetic hints (rPh) of East Asian text repeat it and are skipped
+    scanner.addTextElement("t");
+    scanner.addTextElement("x:t");
+    scanner.addSkippedElement("rPh");
+    scanner.addSkippedElement("x:rPh");
+    scanner.addSeparator("si", '\n');
+    scanner.addSeparator("x:si", '\n');
+}
 
-    const KArchiveDirectory* rootDir = zip.directory();
-    if (!rootDir) {
-        qWarning() << "Invalid document structure (main directory is missing)";
-        return;
-    }
+void setupWorksheetScanner(XmlTextScanner& scanner)
+{
+    scanner.addTextElement("is");
+    scanner.addTextElement("x:is");
+    scanner.addSkippedElement("rPh");
+    scanner.addSkippedElement("x:rPh");
+    scanner.addSeparator("is", '\n');
+    scanner.addSeparator("x:is", '\n');
+}
 
-    const QStringList rootEntries = rootDir->entries();
-    if (!rootEntries.contains("docProps")) {
-        qWarning() << "Invalid document structure (docProps is missing)";
-        return;
-    }
+/**
+ * Inflates and scans a single part of the package
+ */
+class PartScanner
+{
+public:
+    typedef QString result_type;
 
-    const KArchiveEntry* docPropEntry = rootDir->entry("docProps");
-    if (!docPropEntry->isDirectory()) {
-        qWarning() << "Invalid document structure (docProps is not a directory)";
-        return;
+    PartScanner(ZipContainer& zip, ScannerSetup setup)
+        : m_zip(zip)
+        , m_setup(setup)
+    {
     }
 
-    const KArchiveDirectory* docPropDirectory = dynamic_cast<const KArchiveDirectory*>(docPropEntry);
-    const QStringList docPropsEntries = docPropDirectory->entries();
+    QString operator()(const QString& partName) const
+    {
+        QScopedPointer<QIODevice> device(m_zip.device(partName));
+        if (!device)
+            return QString();
 
-    if (docPropsEntries.contains("core.xml")) {
-        QDomDocument coreDoc("core");
-        const KArchiveFile* file = static_cast<const KArchiveFile*>(docPropDirectory->entry("core.xml"));
-        coreDoc.setContent(file->data());
+        XmlTextScanner scanner;
+        m_setup(scanner);
+        return scanner.scanToString(device.data());
+    }
 
-        QDomElement docElem = coreDoc.documentElement();
+    void extract(const QString& partName, ExtractionResult* result) const
+    {
+        QScopedPointer<QIODevice> device(m_zip.device(partName));
+        if (!device)
+            return;
 
-        QDomElement elem = docElem.firstChildElement("dc:description");
-        if (!elem.isNull()) {
-            QString str = elem.text();
-            if (!str.isEmpty()) {
-                result->add(Property::Description, str);
-            }
-        }
+        XmlTextScanner scanner;
+        m_setup(scanner);
+        scanner.scan(device.data(), result);
+    }
 
-        elem = docElem.firstChildElement("dc:subject");
-        if (!elem.isNull()) {
-            QString str = elem.text();
-            if (!str.isEmpty()) {
-                result->add(Property::Subject, str);
-            }
-        }
+private:
+    ZipContainer& m_zip;
+    ScannerSetup m_setup;
+};
+}
 
-        elem = docElem.firstChildElement("dc:title");
-        if (!elem.isNull()) {
-            QString str = elem.text();
-            if (!str.isEmpty()) {
-                result->add(Property::Title, str);
-            }
-        }
+Office2007Extractor::Office2007Extractor(QObject* parent, const QVariantList&): ExtractorPlugin(parent)
+{
 
-        elem = docElem.firstChildElement("dc:creator");
-        if (!elem.isNull()) {
-            QString str = elem.text();
-            if (!str.isEmpty()) {
-                result->add(Property::Creator, str);
-            }
-        }
+}
 
-        elem = docElem.firstChildElement("dc:langauge");
-        if (!elem.isNull()) {
-            QString str = elem.text();
-            if (!str.isEmpty()) {
-                result->add(Property::Langauge, str);
-            }
-        }
-    }
 
-    if (docPropsEntries.contains("app.xml")) {
-        QDomDocument appDoc("app");
-        const KArchiveFile* file = static_cast<const KArchiveFile*>(docPropDirectory->entry("app.xml"));
-        appDoc.setContent(file->data());
-
-        QDomElement docElem = appDoc.documentElement();
-
-        // According to the ontologies only Documents can have a wordCount and pageCount
-        const QString mimeType = result->inputMimetype();
-        if (mimeType == QLatin1String("application/vnd.openxmlformats-officedocument.wordprocessingml.document")) {
-            QDomElement elem = docElem.firstChildElement("Pages");
-            if (!elem.isNull()) {
-                bool ok = false;
-                int pageCount = elem.text().toInt(&ok);
-                if (ok) {
-                    result->add(Property::PageCount, pageCount);
-                }
-            }
+QStringList Office2007Extractor::mimetypes() const
+{
+    QStringList list;
+    list << QLatin1String("application/vnd.openxmlformats-officedocument.wordprocessingml.document")
+         << QLatin1String("application/vnd.openxmlformats-officedocument.presentationml.presentation")
+         << QLatin1String("application/vnd.openxmlformats-officedocument.spreadsheetml.sheet");
 
-            elem = docElem.firstChildElement("Words");
-            if (!elem.isNull()) {
-                bool ok = false;
-                int wordCount = elem.text().toInt(&ok);
-                if (ok) {
-                    result->add(Property::WordCount, wordCount);
-                }
-            }
-        }
+    return list;
+}
 
-        QDomElement elem = docElem.firstChildElement("Application");
-        if (!elem.isNull()) {
-            QString app = elem.text();
-            if (!app.isEmpty()) {
-                result->add(Property::Generator, app);
-            }
-        }
+void Office2007Extractor::extract(ExtractionResult* result)
+{
+    ZipContainer zip(result->inputUrl());
+    if (!zip.isValid()) {
+        qWarning() << "Document is not a valid ZIP archive";
+        return;
     }
 
+    if (!containsDirectory(zip, QLatin1String("docProps"))) {
+        qWarning() << "Invalid document structure (docProps is missing)";
+        return;
+    }
 
-    if (rootEntries.contains("word")) {
-        const KArchiveEntry* wordEntry = rootDir->entry("word");
-        if (!wordEntry->isDirectory()) {
-            qWarning() << "Invalid document structure (word is not a directory)";
-            return;
-        }
+    readXmlMetaData(zip.data(QLatin1String("docProps/core.xml")), coreElements,
+                    sizeof(coreElements) / sizeof(coreElements[0]), result);
 
-        const KArchiveDirectory* wordDirectory = dynamic_cast<const KArchiveDirectory*>(wordEntry);
-        const QStringList wordEntries = wordDirectory->entries();
+    const QByteArray app = zip.data(QLatin1String("docProps/app.xml"));
+    const QString mimeType = result->inputMimetype();
+    if (mimeType == QLatin1String("application/vnd.openxmlformats-officedocument.wordprocessingml.document")) {
+        readXmlMetaData(app, documentAppElements, sizeof(documentAppElements) / sizeof(documentAppElements[0]), result);
+    } else {
+        readXmlMetaData(app, appElements, sizeof(appElements) / sizeof(appElements[0]), result);
+    }
 
-        if (wordEntries.contains("document.xml")) {
-            const KArchiveFile* file = static_cast<const KArchiveFile*>(wordDirectory->entry("document.xml"));
+    const bool extractText = result->inputFlags() & ExtractionResult::ExtractPlainText;
 
-            extractTextWithTag(file->createDevice(), QLatin1String("w:t"), result);
-        }
+    if (containsDirectory(zip, QLatin1String("word"))) {
+        if (extractText)
+            extractDocument(zip, result);
 
         result->addType(Type::Document);
     }
 
-    else if (rootEntries.contains("xl")) {
-        const KArchiveEntry* xlEntry = rootDir->entry("xl");
-        if (!xlEntry->isDirectory()) {
-            qWarning() << "Invalid document structure (xl is not a directory)";
-            return;
-        }
-
-        const KArchiveDirectory* xlDirectory = dynamic_cast<const KArchiveDirectory*>(xlEntry);
-        extractTextFromFiles(xlDirectory, result);
+    else if (containsDirectory(zip, QLatin1String("xl"))) {
+        extractSpreadsheet(zip, result, extractText);
 
         result->addType(Type::Document);
         result->addType(Type::Spreadsheet);
     }
 
-    else if (rootEntries.contains("ppt")) {
-        const KArchiveEntry* pptEntry = rootDir->entry("ppt");
-        if (!pptEntry->isDirectory()) {
-            qWarning() << "Invalid document structure (ppt is not a directory)";
-            return;
-        }
-
-        const KArchiveDirectory* pptDirectory = dynamic_cast<const KArchiveDirectory*>(pptEntry);
-        extractTextFromFiles(pptDirectory, result);
+    else if (containsDirectory(zip, QLatin1String("ppt"))) {
+        extractPresentation(zip, result, extractText);
 
         result->addType(Type::Document);
         result->addType(Type::Presentation);
@@ -210,58 +253,118 @@ void Office2007Extractor::extract(ExtractionResult* result)
     return;
 }
 
-void Office2007Extractor::extractAllText(QIODevice* device, ExtractionResult* result)
+void Office2007Extractor::extractDocument(ZipContainer& zip, ExtractionResult* result)
 {
-    QXmlStreamReader xml(device);
-
-    while (!xml.atEnd()) {
-        xml.readNext();
-        if (xml.isCharacters()) {
-            QString str = xml.text().toString();
-            result->append(str);
-        }
+    // The body comes first, followed by the headers, footers and notes which
+    // all use the same markup
+    QStringList parts;
+    parts << QLatin1String("word/document.xml");
+
+    QStringList headers;
+    QStringList footers;
+    foreach (const QString& entryName, zip.entries()) {
+        if (!entryName.endsWith(QLatin1String(".xml")))
+            continue;
 
-        if (xml.isEndDocument() || xml.hasError())
-            break;
+        if (entryName.startsWith(QLatin1String("word/header")))
+            headers << entryName;
+        else if (entryName.startsWith(QLatin1String("word/footer")))
+            footers << entryName;
     }
+    parts << headers << footers;
+
+    parts << QLatin1String("word/footnotes.xml") << QLatin1String("word/endnotes.xml");
+
+    extractParts(parts, PartScanner(zip, setupDocumentScanner), result);
 }
 
-void Office2007Extractor::extractTextFromFiles(const KArchiveDirectory* archiveDir, ExtractionResult* result)
+void Office2007Extractor::extractSpreadsheet(ZipContainer& zip, ExtractionResult* result, bool extractText)
 {
-    const QStringList entries = archiveDir->entries();
-    foreach(const QString & entryName, entries) {
-        const KArchiveEntry* entry = archiveDir->entry(entryName);
-        if (entry->isDirectory()) {
-            const KArchiveDirectory* subDir = dynamic_cast<const KArchiveDirectory*>(entry);
-            extractTextFromFiles(subDir, result);
-            continue;
+    // The sheet count is taken from the workbook, which lists all the sheets
+    const QByteArray workbook = zip.data(QLatin1String("xl/workbook.xml"));
+    if (!workbook.isEmpty()) {
+        QXmlStreamReader xml(workbook);
+
+        int sheetCount = 0;
+        while (!xml.atEnd()) {
+            xml.readNext();
+            if (xml.isStartElement() && xml.name() == QLatin1String("sheet"))
+                sheetCount++;
+
+            if (xml.isEndDocument() || xml.hasError())
+                break;
         }
 
-        if (!entryName.endsWith(".xml"))
-            continue;
+        if (sheetCount > 0)
+            result->add(Property::SheetCount, sheetCount);
+    }
+
+    if (!extractText)
+        return;
 
-        const KArchiveFile* file = static_cast<const KArchiveFile*>(entry);
-        extractAllText(file->createDevice(), result);
+    // Almost all the text of a workbook is in the shared string table. The
+    // sheets themselves are only read for strings which are stored inline
+    // in the cells. Numbers, formulas and their cached results are skipped.
+    extractParts(QStringList() << QLatin1String("xl/sharedStrings.xml"), PartScanner(zip, setupSharedStringsScanner), result);
+
+    QStringList sheets;
+    const QString prefix = QLatin1String("xl/worksheets/");
+    foreach (const QString& entryName, zip.entries()) {
+        if (entryName.startsWith(prefix) && entryName.endsWith(".xml"))
+            sheets << entryName;
     }
+
+    extractParts(sheets, PartScanner(zip, setupWorksheetScanner), result);
 }
 
-void Office2007Extractor::extractTextWithTag(QIODevice* device, const QString& tag, ExtractionResult* result)
+void Office2007Extractor::extractPresentation(ZipContainer& zip, ExtractionResult* result, bool extractText)
 {
-    QXmlStreamReader xml(device);
+    const QString presentationName = QLatin1String("ppt/presentation.xml");
+    const QHash<QString, QString> slideTargets = readRelationships(zip, presentationName, QLatin1String("/slide"));
 
+    // The slides are listed in the order of the deck, which need not be the order of their names
+    QStringList slides;
+
+    QXmlStreamReader xml(zip.data(presentationName));
     while (!xml.atEnd()) {
         xml.readNext();
-        if (xml.qualifiedName().startsWith(tag) && xml.isStartElement()) {
-            QString str = xml.readElementText(QXmlStreamReader::IncludeChildElements);
-
-            if (!str.isEmpty()) {
-                result->append(str);
+        if (xml.isStartElement() && xml.name() == QLatin1String("sldId")) {
+            foreach (const QXmlStreamAttribute& attribute, xml.attributes()) {
+                if (attribute.name() == QLatin1String("id") && attribute.namespaceUri().endsWith(QLatin1String("/relationships"))) {
+                    const QString slide = slideTargets.value(attribute.value().toString());
+                    if (!slide.isEmpty())
+                        slides << slide;
+                }
             }
         }
 
         if (xml.isEndDocument() || xml.hasError())
             break;
     }
+
+    // Without a usable presentation part, fall back to the order of the archive
+    if (slides.isEmpty()) {
+        foreach (const QString& entryName, zip.entries()) {
+            if (entryName.startsWith(QLatin1String("ppt/slides/")) && entryName.endsWith(QLatin1String(".xml")))
+                slides << entryName;
+        }
+    }
+
+    if (!slides.isEmpty())
+        result->add(Property::SlideCount, slides.size());
+
+    if (!extractText)
+        return;
+
+    // Only the slides and their notes are read. Masters and layouts only contain
+    // template text, which would otherwise be indexed once per layout.
+    QStringList parts;
+    foreach (const QString& slide, slides) {
+        parts << slide;
+        parts << readRelationships(zip, slide, QLatin1String("/notesSlide")).values();
+    }
+
+    extractParts(parts, PartScanner(zip, setupSlideScanner), result);
 }
 
 KFILEMETADATA_EXPORT_EXTRACTOR(KFileMetaData::Office2007Extractor, "kfilemetadata_office2007extractor")
@@ -23,11 +23,11 @@
 
 #include "extractorplugin.h"
 
-class KArchiveDirectory;
-
 namespace KFileMetaData
 {
 
+class ZipContainer;
+
 class Office2007Extractor : public ExtractorPlugin
 {
 public:
@@ -37,9 +37,9 @@ public:
     virtual void extract(ExtractionResult* result);
 
 private:
-    void extractTextWithTag(QIODevice* device, const QString& tag, ExtractionResult* result);
-    void extractAllText(QIODevice* device, ExtractionResult* result);
-    void extractTextFromFiles(const KArchiveDirectory* archiveDir, ExtractionResult* result);
+    void extractDocument(ZipContainer& zip, ExtractionResult* result);
+    void extractSpreadsheet(ZipContainer& zip, ExtractionResult* result, bool extractText);
+    void extractPresentation(ZipContainer& zip, ExtractionResult* result, bool extractText);
 };
 }
 
@@ -18,31 +18,778 @@
 */
 
 #include "officeextractor.h"
+#include "cfbreader.h"
 
 #include <kstandarddirs.h>
 
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QHash>
 #include <QProcess>
+#include <QTextCodec>
+#include <QTextDecoder>
+
+#include <string.h>
 
 using namespace KFileMetaData;
 
-OfficeExtractor::OfficeExtractor(QObject* parent, const QVariantList&)
-    : ExtractorPlugin(parent)
+namespace
+{
+// How long the external tools may run when the ExtractionResult sets no time limit
+const int defaultTimeLimit = 30 * 1000;
+
+/**
+ * Collects the extracted text and passes it on to the ExtractionResult in
+ * large chunks which end at a word boundary. Words and lines are counted
+ * on the way, so the full text never has to be kept in memory.
+ *
+ * When \p deferred is set the chunks are held back until finish(), so
+ * that the text can still be dropped with discard().
+ */
+class TextSink
+{
+public:
+    explicit TextSink(ExtractionResult* result, bool deferred = false)
+        : m_result(result)
+        , m_deferred(deferred)
+        , m_budget(result->textBudget())
+        , m_size(0)
+        , m_words(0)
+        , m_lines(0)
+        , m_inWord(false)
+    {
+    }
+
+    /**
+     * Returns true once the text budget of the ExtractionResult has been
+     * reached, reading any further is pointless
+     */
+    bool isFull() const
+    {
+        return m_budget > 0 && m_size + m_buffer.size() >= m_budget;
+    }
+
+    void append(const QString& text)
+    {
+        m_buffer.append(text);
+        if (m_buffer.size() >= chunkSize)
+            flush(false);
+    }
+
+    void finish()
+    {
+        flush(true);
+
+        foreach (const QString& text, m_chunks)
+            m_result->append(text);
+        m_chunks.clear();
+    }
+
+    void discard()
+    {
+        m_buffer.clear();
+        m_chunks.clear();
+    }
+
+    int wordCount() const
+    {
+        return m_words;
+    }
+
+    int lineCount() const
+    {
+        return m_lines;
+    }
+
+private:
+    static const int chunkSize = 64 * 1024;
+
+    void flush(bool all)
+    {
+        int end = m_buffer.size();
+        if (!all) {
+            end = m_buffer.size() - 1;
+            while (end >= 0 && !m_buffer.at(end).isSpace())
+                end--;
+
+            // Give up on finding a word boundary in huge words
+            if (end < 0 && m_buffer.size() < 4 * chunkSize)
+                return;
+            if (end < 0)
+                end = m_buffer.size();
+        }
+
+        const QChar* data = m_buffer.constData();
+        for (int i = 0; i < end; i++) {
+            const QChar c = data[i];
+            if (c.isLetterOrNumber() || c == QLatin1Char('_')) {
+                if (!m_inWord)
+                    m_words++;
+                m_inWord = true;
+            } else {
+                m_inWord = false;
+                if (c == QLatin1Char('\n'))
+                    m_lines++;
+            }
+        }
+
+        QString text = m_buffer.left(end).trimmed();
+        m_buffer.remove(0, end);
+
+        if (m_budget > 0)
+            text.truncate(qMax(0, m_budget - m_size));
+
+        m_size += text.size();
+        if (text.isEmpty())
+            return;
+
+        if (m_deferred)
+            m_chunks << text;
+        else
+            m_result->append(text);
+    }
+
+    ExtractionResult* m_result;
+    bool m_deferred;
+    int m_budget;
+    int m_size;
+    QString m_buffer;
+    QStringList m_chunks;
+    int m_words;
+    int m_lines;
+    bool m_inWord;
+};
+
+// Word stores 8-bit text in Windows-1252, which only differs from Latin-1 in 0x80 - 0x9F
+const ushort cp1252[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+QString fromCp1252(const char* data, int size)
+{
+    QString text;
+    text.resize(size);
+
+    QChar* out = text.data();
+    for (int i = 0; i < size; i++) {
+        const uchar c = data[i];
+        out[i] = (c >= 0x80 && c < 0xA0) ? QChar(cp1252[c - 0x80]) : QChar(c);
+    }
+    return text;
+}
+
+/**
+ * Replaces the control characters Word uses for paragraphs, cells and
+ * fields. Field codes (such as "HYPERLINK ...") are dropped while the
+ * field results are kept. \p fields keeps track of the nested fields
+ * across calls, it holds true for every field whose code is being read.
+ */
+QString cleanWordText(const QString& raw, QVector<bool>& fields)
+{
+    QString text;
+    text.reserve(raw.size());
+
+    const QChar* data = raw.constData();
+    for (int i = 0; i < raw.size(); i++) {
+        const ushort c = data[i].unicode();
+
+        switch (c) {
+        case 0x13: // Field begin
+            fields.push_back(true);
+            continue;
+        case 0x14: // Field separator
+            if (!fields.isEmpty())
+                fields.last() = false;
+            continue;
+        case 0x15: // Field end
+            if (!fields.isEmpty())
+                fields.pop_back();
+            continue;
+        }
+
+        if (!fields.isEmpty() && fields.contains(true))
+            continue;
+
+        switch (c) {
+        case 0x0D: // Paragraph end
+        case 0x0B: // Line break
+        case 0x0C: // Page break
+            text.append(QLatin1Char('\n'));
+            break;
+        case 0x07: // Cell end
+        case 0x09:
+            text.append(QLatin1Char('\t'));
+            break;
+        case 0x1E: // Non-breaking hyphen
+            text.append(QLatin1Char('-'));
+            break;
+        case 0xA0:
+            text.append(QLatin1Char(' '));
+            break;
+        default:
+            // Drop the remaining control characters, such as object anchors
+            if (c >= 0x20)
+                text.append(data[i]);
+        }
+    }
+
+    return text;
+}
+
+/**
+ * Reads the data of a BIFF record together with the CONTINUE records
+ * following it, as records are limited to 8 KiB and longer data such
+ * as the shared string table is split over several of them.
+ */
+class ContinuedRecord
+{
+public:
+    ContinuedRecord(StreamBuffer& buffer, qint64 dataStart, int dataSize)
+        : m_buffer(buffer)
+        , m_position(dataStart)
+        , m_end(dataStart + dataSize)
+    {
+    }
+
+    /**
+     * Reads \p size bytes into \p out, or just skips them if \p out is 0
+     */
+    bool read(char* out, qint64 size)
+    {
+        while (size > 0) {
+            if (m_position == m_end && !nextRecord())
+                return false;
+
+            const int n = qMin(size, m_end - m_position);
+            if (out) {
+                const char* data = m_buffer.data(m_position, n);
+                if (!data)
+                    return false;
+
+                memcpy(out, data, n);
+                out += n;
+            }
+
+            m_position += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    /**
+     * Reads \p length characters of a string which are stored as 8-bit
+     * Latin-1 or as UTF-16 depending on \p highByte
+     */
+    bool readString(int length, bool highByte, QString& out)
+    {
+        out.clear();
+
+        while (length > 0) {
+            if (m_position == m_end) {
+                if (!nextRecord())
+                    return false;
+
+                // Characters continued in a new record are preceded by new flags
+                const char* flags = m_buffer.data(m_position, 1);
+                if (!flags)
+                    return false;
+
+                highByte = *flags & 0x01;
+                m_position++;
+            }
+
+            const int charSize = highByte ? 2 : 1;
+            const int n = qMin<qint64>(length, (m_end - m_position) / charSize);
+            const char* data = m_buffer.data(m_position, n * charSize);
+            if (n == 0 || !data)
+                return false;
+
+            if (highByte) {
+                const int start = out.size();
+                out.resize(start + n);
+
+                QChar* chars = out.data() + start;
+                for (int i = 0; i < n; i++)
+                    chars[i] = QChar(readUInt16(data + i * 2));
+            } else {
+                out.append(QString::fromLatin1(data, n));
+            }
+
+            m_position += n * charSize;
+            length -= n;
+        }
+        return true;
+    }
+
+private:
+    bool nextRecord()
+    {
+        const char* header = m_buffer.data(m_end, 4);
+        if (!header || readUInt16(header) != 0x003C)
+            return false;
+
+        m_position = m_end + 4;
+        m_end = m_position + readUInt16(header + 2);
+        return true;
+    }
+
+    StreamBuffer& m_buffer;
+    qint64 m_position;
+    qint64 m_end;
+};
+
+/**
+ * Passes on the strings of the shared string table (SST) record. Only the
+ * text is read, formatting runs and phonetic data are skipped.
+ */
+void extractSharedStrings(StreamBuffer& buffer, qint64 dataStart, int dataSize, TextSink& sink)
+{
+    ContinuedRecord record(buffer, dataStart, dataSize);
+
+    char header[8];
+    if (!record.read(header, 8))
+        return;
+
+    const quint32 count = readUInt32(header + 4);
+
+    QString str;
+    for (quint32 i = 0; i < count && !sink.isFull(); i++) {
+        if (!record.read(header, 3))
+            return;
+
+        const int length = readUInt16(header);
+        const quint8 flags = header[2];
+
+        qint64 skip = 0;
+        if (flags & 0x08) {
+            if (!record.read(header, 2))
+                return;
+            skip += readUInt16(header) * 4;
+        }
+        if (flags & 0x04) {
+            if (!record.read(header, 4))
+                return;
+            skip += readUInt32(header);
+        }
+
+        if (!record.readString(length, flags & 0x01, str) || !record.read(0, skip))
+            return;
+
+        if (!str.isEmpty()) {
+            sink.append(str);
+            sink.append(QLatin1String("\n"));
+        }
+    }
+}
+
+//
+// PowerPoint records
+//
+const quint16 documentContainer = 0x03E8;
+const quint16 slideContainer = 0x03EE;
+const quint16 slideAtom = 0x03EF;
+const quint16 notesContainer = 0x03F0;
+const quint16 slidePersistAtom = 0x03F3;
+const quint16 mainMasterContainer = 0x03F8;
+const quint16 textCharsAtom = 0x0FA0;
+const quint16 textBytesAtom = 0x0FA8;
+const quint16 slideListWithTextContainer = 0x0FF0;
+const quint16 userEditAtom = 0x0FF5;
+const quint16 currentUserAtom = 0x0FF6;
+const quint16 persistDirectoryAtom = 0x1772;
+const quint16 cryptSession10Container = 0x2F14;
+
+const quint32 encryptedDocumentToken = 0xF3D1C4DF;
+
+/**
+ * Returns the text of a TextCharsAtom or TextBytesAtom
+ */
+QString textFromAtom(quint16 type, const char* data, quint32 size)
+{
+    QString text;
+    if (type == textCharsAtom) {
+        // UTF-16
+        text.resize(size / 2);
+        QChar* chars = text.data();
+        for (quint32 i = 0; i < size / 2; i++)
+            chars[i] = QChar(readUInt16(data + i * 2));
+    } else {
+        // The high bytes of UTF-16 stripped
+        text = QString::fromLatin1(data, size);
+    }
+
+    // Paragraphs are separated by carriage returns, line breaks by vertical tabs
+    text.replace(QLatin1Char('\r'), QLatin1Char('\n'));
+    text.replace(QChar(0x0B), QLatin1Char('\n'));
+
+    return text;
+}
+
+/**
+ * Appends the text of all the records between \p position and \p end.
+ * Records form a tree. Containers are entered by just moving past their
+ * header, so all the atoms are visited in the order they are stored.
+ * Returns false if the presentation turns out to be encrypted.
+ */
+bool appendRecordText(StreamBuffer& buffer, qint64 position, qint64 end, TextSink& sink)
+{
+    while (position < end && !sink.isFull()) {
+        const char* header = buffer.data(position, 8);
+        if (!header)
+            break;
+
+        const bool isContainer = (readUInt16(header) & 0x000F) == 0x000F;
+        const quint16 type = readUInt16(header + 2);
+        const quint32 size = readUInt32(header + 4);
+        const qint64 dataStart = position + 8;
+
+        if (type == cryptSession10Container)
+            return false;
+
+        // Skip the master slides, their placeholder text is the same for every file
+        if (isContainer && type != mainMasterContainer) {
+            position = dataStart;
+            continue;
+        }
+
+        position = dataStart + size;
+
+        if (type != textCharsAtom && type != textBytesAtom)
+            continue;
+
+        const char* data = buffer.data(dataStart, size);
+        if (!data)
+            break;
+
+        sink.append(textFromAtom(type, data, size));
+        sink.append(QLatin1String("\n"));
+    }
+
+    return true;
+}
+
+/**
+ * Appends the text of the record at \p position, if it is of the given \p type
+ */
+void appendContainerText(StreamBuffer& buffer, qint64 position, quint16 type, TextSink& sink)
 {
-    // Find the executables of catdoc, catppt and xls2csv. If an executable cannot
-    // be found, indexing its corresponding MIME type will be disabled
-    findExe("application/msword", "catdoc", m_catdoc);
-    findExe("application/vnd.ms-excel", "xls2csv", m_xls2csv);
-    findExe("application/vnd.ms-powerpoint", "catppt", m_catppt);
+    const char* header = buffer.data(position, 8);
+    if (header && readUInt16(header + 2) == type)
+        appendRecordText(buffer, position + 8, position + 8 + readUInt32(header + 4), sink);
 }
 
-void OfficeExtractor::findExe(const QString& mimeType, const QString& name, QString& fullPath)
+/**
+ * A slide or notes slide of a SlideListWithTextContainer, together with
+ * the outline text of its placeholders which is stored in the list
+ */
+struct SlideListEntry {
+    quint32 persistId;
+    quint32 slideId;
+    QString text;
+};
+
+/**
+ * Reads the entries of the SlideListWithTextContainer whose data is
+ * between \p position and \p end
+ */
+QVector<SlideListEntry> readSlideList(StreamBuffer& buffer, qint64 position, qint64 end)
 {
-    fullPath = KStandardDirs::findExe(name);
+    QVector<SlideListEntry> entries;
+
+    while (position < end) {
+        const char* header = buffer.data(position, 8);
+        if (!header)
+            break;
 
-    if (!fullPath.isEmpty()) {
-        m_available_mime_types << mimeType;
+        const quint16 type = readUInt16(header + 2);
+        const quint32 size = readUInt32(header + 4);
+        const qint64 dataStart = position + 8;
+        position = dataStart + size;
+
+        if (type == slidePersistAtom && size >= 16) {
+            const char* data = buffer.data(dataStart, 16);
+            if (!data)
+                break;
+
+            SlideListEntry entry;
+            entry.persistId = readUInt32(data);
+            entry.slideId = readUInt32(data + 12);
+            entries << entry;
+        } else if ((type == textCharsAtom || type == textBytesAtom) && !entries.isEmpty()) {
+            const char* data = buffer.data(dataStart, size);
+            if (!data)
+                break;
+
+            entries.last().text += textFromAtom(type, data, size) + QLatin1Char('\n');
+        }
     }
+
+    return entries;
+}
+
+/**
+ * Collects the offsets of the current version of every persistent object,
+ * such as the document and the slides, starting with the edit at \p offset.
+ * Every incremental save adds an edit which only lists the changed objects.
+ */
+QHash<quint32, quint32> readPersistDirectory(StreamBuffer& buffer, quint32 offset, quint32* documentPersistId)
+{
+    QHash<quint32, quint32> offsets;
+
+    bool newest = true;
+    while (true) {
+        const char* edit = buffer.data(offset, 28);
+        if (!edit || readUInt16(edit + 2) != userEditAtom)
+            break;
+
+        const quint32 lastEdit = readUInt32(edit + 16);
+        const quint32 directory = readUInt32(edit + 20);
+        if (newest)
+            *documentPersistId = readUInt32(edit + 24);
+        newest = false;
+
+        const char* header = buffer.data(directory, 8);
+        if (!header || readUInt16(header + 2) != persistDirectoryAtom)
+            break;
+
+        qint64 position = qint64(directory) + 8;
+        const qint64 end = position + readUInt32(header + 4);
+        while (position + 4 <= end) {
+            const char* entry = buffer.data(position, 4);
+            if (!entry)
+                break;
+
+            // 20 bits of the first persist id, 12 bits of the number of offsets following
+            const quint32 persistId = readUInt32(entry) & 0xFFFFF;
+            const int count = readUInt32(entry) >> 20;
+            position += 4;
+
+            const char* data = buffer.data(position, count * 4);
+            if (!data || position + count * 4 > end)
+                break;
+
+            // Newer edits come first and take precedence
+            for (int i = 0; i < count; i++) {
+                if (!offsets.contains(persistId + i))
+                    offsets.insert(persistId + i, readUInt32(data + i * 4));
+            }
+            position += count * 4;
+        }
+
+        // Edits are appended to the stream, so older ones are stored before newer ones.
+        // This also stops loops in corrupt files.
+        if (lastEdit == 0 || lastEdit >= offset)
+            break;
+        offset = lastEdit;
+    }
+
+    return offsets;
+}
+
+/**
+ * Appends the text of the current version of the slides, each followed by
+ * its notes, in the order of the presentation. Returns false if the slides
+ * cannot be found through the persist directory, nothing is appended then.
+ */
+bool appendSlideText(StreamBuffer& buffer, quint32 currentEdit, TextSink& sink)
+{
+    quint32 documentPersistId = 0;
+    const QHash<quint32, quint32> offsets = readPersistDirectory(buffer, currentEdit, &documentPersistId);
+    if (!offsets.contains(documentPersistId))
+        return false;
+
+    const qint64 documentOffset = offsets.value(documentPersistId);
+    const char* header = buffer.data(documentOffset, 8);
+    if (!header || readUInt16(header + 2) != documentContainer)
+        return false;
+
+    // The slides and the notes are listed in the document, the masters are not needed
+    QVector<SlideListEntry> slides;
+    QVector<SlideListEntry> notes;
+
+    qint64 position = documentOffset + 8;
+    const qint64 end = position + readUInt32(header + 4);
+    while (position < end) {
+        header = buffer.data(position, 8);
+        if (!header)
+            return false;
+
+        const quint16 instance = readUInt16(header) >> 4;
+        const quint16 type = readUInt16(header + 2);
+        const quint32 size = readUInt32(header + 4);
+        const qint64 dataStart = position + 8;
+        position = dataStart + size;
+
+        if (type != slideListWithTextContainer)
+            continue;
+
+        if (instance == 0)
+            slides = readSlideList(buffer, dataStart, position);
+        else if (instance == 2)
+            notes = readSlideList(buffer, dataStart, position);
+    }
+
+    foreach (const SlideListEntry& slide, slides) {
+        if (sink.isFull())
+            break;
+
+        sink.append(slide.text);
+
+        const qint64 slideOffset = offsets.value(slide.persistId, 0);
+        appendContainerText(buffer, slideOffset, slideContainer, sink);
+
+        // The SlideAtom at the start of the slide refers to the notes by their id
+        header = buffer.data(slideOffset, 8 + 8 + 20);
+        if (!header || readUInt16(header + 2) != slideContainer || readUInt16(header + 10) != slideAtom)
+            continue;
+
+        const quint32 notesId = readUInt32(header + 16 + 16);
+        if (notesId == 0)
+            continue;
+
+        foreach (const SlideListEntry& note, notes) {
+            if (note.slideId == notesId) {
+                sink.append(note.text);
+                appendContainerText(buffer, offsets.value(note.persistId, 0), notesContainer, sink);
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Reads the first property set of a SummaryInformation or
+ * DocumentSummaryInformation stream. Only the simple types used by the
+ * properties we are interested in are supported.
+ */
+QHash<quint32, QVariant> readPropertySet(const QByteArray& stream)
+{
+    QHash<quint32, QVariant> properties;
+
+    const char* data = stream.constData();
+    const int size = stream.size();
+    if (size < 48 || readUInt16(data) != 0xFFFE)
+        return properties;
+
+    const quint32 setOffset = readUInt32(data + 44);
+    if (setOffset > quint32(size - 8))
+        return properties;
+
+    const char* set = data + setOffset;
+    const quint32 setSize = qMin<quint32>(readUInt32(set), size - setOffset);
+    const quint32 count = readUInt32(set + 4);
+    if (setSize < 8 || count > (setSize - 8) / 8)
+        return properties;
+
+    // The code page is needed to decode the 8-bit strings, it is usually the first property
+    QTextCodec* codec = 0;
+    int codePage = 1252;
+    for (quint32 i = 0; i < count; i++) {
+        const quint32 offset = readUInt32(set + 12 + i * 8);
+        if (readUInt32(set + 8 + i * 8) == 1 && offset <= setSize - 6 && readUInt16(set + offset) == 2) {
+            codePage = readUInt16(set + offset + 4);
+            break;
+        }
+    }
+    if (codePage != 1252 && codePage != 1200 && codePage != 65001)
+        codec = QTextCodec::codecForName("CP" + QByteArray::number(codePage));
+
+    for (quint32 i = 0; i < count; i++) {
+        const quint32 id = readUInt32(set + 8 + i * 8);
+        const quint32 offset = readUInt32(set + 12 + i * 8);
+        if (offset > setSize - 8)
+            continue;
+
+        const char* value = set + offset + 4;
+        const quint32 available = setSize - offset - 4;
+
+        switch (readUInt16(set + offset)) {
+        case 2: // VT_I2
+            properties.insert(id, qint16(readUInt16(value)));
+            break;
+        case 3: // VT_I4
+            properties.insert(id, qint32(readUInt32(value)));
+            break;
+        case 0x1E: { // VT_LPSTR, the length includes the terminating null
+            const quint32 length = readUInt32(value);
+            if (length > available - 4)
+                break;
+
+            const char* str = value + 4;
+            int n = 0;
+            while (n < int(length) && str[n])
+                n++;
+
+            QString text;
+            if (codePage == 65001)
+                text = QString::fromUtf8(str, n);
+            else if (codePage == 1200)
+                text = QString::fromUtf16(reinterpret_cast<const ushort*>(str), length / 2).section(QChar(0), 0, 0);
+            else if (codec)
+                text = codec->toUnicode(str, n);
+            else if (codePage == 1252)
+                text = fromCp1252(str, n);
+            else
+                text = QString::fromLatin1(str, n);
+
+            text = text.trimmed();
+            if (!text.isEmpty())
+                properties.insert(id, text);
+            break;
+        }
+        case 0x1F: { // VT_LPWSTR, the length is in characters
+            const quint32 length = readUInt32(value);
+            if (length > (available - 4) / 2)
+                break;
+
+            QString text;
+            text.resize(length);
+            QChar* chars = text.data();
+            for (quint32 j = 0; j < length; j++)
+                chars[j] = QChar(readUInt16(value + 4 + j * 2));
+
+            text = text.section(QChar(0), 0, 0).trimmed();
+            if (!text.isEmpty())
+                properties.insert(id, text);
+            break;
+        }
+        case 0x40: { // VT_FILETIME, 100ns intervals since 1601
+            if (available < 8)
+                break;
+
+            const quint64 fileTime = readUInt32(value) | (quint64(readUInt32(value + 4)) << 32);
+            if (fileTime == 0)
+                break;
+
+            const qint64 msecs = qint64(fileTime / 10000) - Q_INT64_C(11644473600000);
+            properties.insert(id, QDateTime::fromMSecsSinceEpoch(msecs).toUTC());
+            break;
+        }
+        }
+    }
+
+    return properties;
+}
+}
+
+OfficeExtractor::OfficeExtractor(QObject* parent, const QVariantList&)
+    : ExtractorPlugin(parent)
+{
+    // All the formats are read natively. catdoc, xls2csv and catppt are only used
+    // for the older versions we cannot parse ourselves, if they are installed.
+    m_available_mime_types << QLatin1String("application/msword")
+                           << QLatin1String("application/vnd.ms-excel")
+                           << QLatin1String("application/vnd.ms-powerpoint");
+
+    m_catdoc = KStandardDirs::findExe(QLatin1String("catdoc"));
+    m_xls2csv = KStandardDirs::findExe(QLatin1String("xls2csv"));
+    m_catppt = KStandardDirs::findExe(QLatin1String("catppt"));
 }
 
 QStringList OfficeExtractor::mimetypes() const
@@ -54,64 +801,348 @@ QStringList OfficeExtractor::mimetypes() const
 void OfficeExtractor::extract(ExtractionResult* result)
 {
     QStringList args;
-    QString contents;
 
     args << QLatin1String("-s") << QLatin1String("cp1252"); // FIXME: Store somewhere a map between the user's language and the encoding of the Windows files it may use ?
     args << QLatin1String("-d") << QLatin1String("utf8");
 
     const QString fileUrl = result->inputUrl();
     const QString mimeType = result->inputMimetype();
+    const bool extractText = result->inputFlags() & ExtractionResult::ExtractPlainText;
+
+    CfbReader reader(fileUrl);
+
     if (mimeType == QLatin1String("application/msword")) {
         result->addType(Type::Document);
 
-        args << QLatin1String("-w");
-        contents = textFromFile(fileUrl, m_catdoc, args);
-
-        // Now that we have the plain text content, count words, lines and characters
-        // (original code from plaintextextractor.cpp, authored by Vishesh Handa)
-        int lines = contents.count(QLatin1Char('\n'));
-        int words = contents.count(QRegExp("\\b\\w+\\b"));
+        // Word and line counts from the properties are only used if we do not count them ourselves
+        extractSummaryInformation(reader, result, !extractText);
+        if (!extractText || extractWordDocument(reader, result) || m_catdoc.isEmpty())
+            return;
 
-        result->add(Property::WordCount, words);
-        result->add(Property::LineCount, lines);
+        args << QLatin1String("-w");
+        textFromFile(fileUrl, m_catdoc, args, result, true);
     } else if (mimeType == QLatin1String("application/vnd.ms-excel")) {
         result->addType(Type::Document);
         result->addType(Type::Spreadsheet);
 
+        extractSummaryInformation(reader, result, true);
+        if (!extractText || extractExcelDocument(reader, result) || m_xls2csv.isEmpty())
+            return;
+
         args << QLatin1String("-c") << QLatin1String(" ");
         args << QLatin1String("-b") << QLatin1String(" ");
         args << QLatin1String("-q") << QLatin1String("0");
-        contents = textFromFile(fileUrl, m_xls2csv, args);
+        textFromFile(fileUrl, m_xls2csv, args, result, false);
     } else if (mimeType == QLatin1String("application/vnd.ms-powerpoint")) {
         result->addType(Type::Document);
         result->addType(Type::Presentation);
 
-        contents = textFromFile(fileUrl, m_catppt, args);
-    }
+        extractSummaryInformation(reader, result, true);
+        if (!extractText || extractPowerPointDocument(reader, result) || m_catppt.isEmpty())
+            return;
 
-    if (contents.isEmpty())
-        return;
-
-    result->append(contents);
-
-    return;
+        textFromFile(fileUrl, m_catppt, args, result, false);
+    }
 }
 
-QString OfficeExtractor::textFromFile(const QString& fileUrl, const QString& command, QStringList& arguments)
+void OfficeExtractor::textFromFile(const QString& fileUrl, const QString& command, QStringList& arguments,
+                                   ExtractionResult* result, bool addStatistics)
 {
     arguments << fileUrl;
 
-    // Start a process and read its standard output
+    // Start a process and pass on its standard output as it arrives
     QProcess process;
 
     process.setReadChannel(QProcess::StandardOutput);
     process.start(command, arguments, QIODevice::ReadOnly);
-    process.waitForFinished();
+    if (!process.waitForStarted())
+        return;
+
+    const int timeLimit = result->timeLimit() > 0 ? result->timeLimit() : defaultTimeLimit;
+    QElapsedTimer timer;
+    timer.start();
+
+    // Only the output of tools which succeed is kept
+    TextSink sink(result, true);
+    QTextDecoder decoder(QTextCodec::codecForName("UTF-8"));
+
+    // The tools are stopped once we have enough text or they take too long
+    while (!sink.isFull()) {
+        const int remaining = timeLimit - int(timer.elapsed());
+        if (remaining <= 0)
+            break;
+
+        if (process.waitForReadyRead(remaining)) {
+            sink.append(decoder.toUnicode(process.readAll()));
+        } else if (process.state() == QProcess::NotRunning) {
+            sink.append(decoder.toUnicode(process.readAll()));
+            break;
+        }
+    }
+
+    // Tools we stopped ourselves have not failed, their text so far is kept
+    bool stopped = false;
+    if (process.state() != QProcess::NotRunning) {
+        process.kill();
+        process.waitForFinished();
+        stopped = true;
+    }
+
+    if (!stopped && (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)) {
+        sink.discard();
+        return;
+    }
+
+    sink.finish();
+
+    if (addStatistics) {
+        result->add(Property::WordCount, sink.wordCount());
+        result->add(Property::LineCount, sink.lineCount());
+    }
+}
+
+void OfficeExtractor::extractSummaryInformation(CfbReader& reader, ExtractionResult* result, bool includeStatistics)
+{
+    // Both streams are tiny, usually stored in the mini stream, so this only costs a few sectors
+    const CfbReader::Stream summaryStream = reader.stream(QLatin1String("\005SummaryInformation"));
+    if (summaryStream.isValid() && summaryStream.size() <= 64 * 1024) {
+        const QHash<quint32, QVariant> properties = readPropertySet(reader.read(summaryStream, 0, summaryStream.size()));
+
+        QHash<quint32, QVariant>::const_iterator it = properties.constBegin();
+        for (; it != properties.constEnd(); ++it) {
+            switch (it.key()) {
+            case 2:
+                result->add(Property::Title, it.value());
+                break;
+            case 3:
+                result->add(Property::Subject, it.value());
+                break;
+            case 4:
+                result->add(Property::Author, it.value());
+                break;
+            case 5:
+                result->add(Property::Keywords, it.value());
+                break;
+            case 6:
+                result->add(Property::Comment, it.value());
+                break;
+            case 12:
+                result->add(Property::CreationDate, it.value());
+                break;
+            case 14:
+                if (it.value().toInt() > 0)
+                    result->add(Property::PageCount, it.value());
+                break;
+            case 15:
+                if (includeStatistics && it.value().toInt() > 0)
+                    result->add(Property::WordCount, it.value());
+                break;
+            case 18:
+                result->add(Property::Generator, it.value());
+                break;
+            }
+        }
+    }
+
+    const CfbReader::Stream documentStream = reader.stream(QLatin1String("\005DocumentSummaryInformation"));
+    if (documentStream.isValid() && documentStream.size() <= 64 * 1024) {
+        const QHash<quint32, QVariant> properties = readPropertySet(reader.read(documentStream, 0, documentStream.size()));
+
+        if (includeStatistics && properties.value(5).toInt() > 0)
+            result->add(Property::LineCount, properties.value(5));
+
+        // Presentations store their slide count here. It is not reported as
+        // a PageCount, which only documents have.
+        if (properties.value(7).toInt() > 0)
+            result->add(Property::SlideCount, properties.value(7));
+    }
+}
+
+bool OfficeExtractor::extractWordDocument(CfbReader& reader, ExtractionResult* result)
+{
+    const CfbReader::Stream wordStream = reader.stream(QLatin1String("WordDocument"));
+    if (!wordStream.isValid())
+        return false;
+
+    // The File Information Block, we need everything up to the location of the piece table
+    const QByteArray fib = reader.read(wordStream, 0, 0x1AA);
+    if (fib.isEmpty() || readUInt16(fib.constData()) != 0xA5EC)
+        return false;
+
+    // Word 95 and older use a different layout
+    if (readUInt16(fib.constData() + 0x02) < 0xC1 ||
+            readUInt16(fib.constData() + 0x20) != 14 || readUInt16(fib.constData() + 0x3E) != 22)
+        return false;
+
+    const quint16 flags = readUInt16(fib.constData() + 0x0A);
+    if (flags & 0x0100) {
+        // Encrypted, there is nothing we can do
+        return true;
+    }
+
+    const QString tableName = (flags & 0x0200) ? QLatin1String("1Table") : QLatin1String("0Table");
+    const CfbReader::Stream tableStream = reader.stream(tableName);
+
+    const quint32 fcClx = readUInt32(fib.constData() + 0x1A2);
+    const quint32 lcbClx = readUInt32(fib.constData() + 0x1A6);
+    const QByteArray clx = reader.read(tableStream, fcClx, lcbClx);
+    if (clx.isEmpty())
+        return false;
+
+    // Skip the formatting (Prc) entries in front of the piece table (Pcdt)
+    int pos = 0;
+    while (pos + 3 <= clx.size() && clx.at(pos) == 0x01) {
+        pos += 3 + readUInt16(clx.constData() + pos + 1);
+    }
+
+    if (pos + 5 > clx.size() || clx.at(pos) != 0x02)
+        return false;
+
+    const quint32 lcb = readUInt32(clx.constData() + pos + 1);
+    pos += 5;
+    if (lcb < 4 || lcb > quint32(clx.size() - pos))
+        return false;
+
+    // The piece table consists of n + 1 character positions followed by n piece descriptors
+    const int pieceCount = (lcb - 4) / 12;
+    const char* cps = clx.constData() + pos;
+    const char* pcds = cps + (pieceCount + 1) * 4;
+
+    TextSink sink(result);
+    QVector<bool> fields;
+    QByteArray buffer;
+
+    for (int i = 0; i < pieceCount && !sink.isFull(); i++) {
+        const qint64 length = qint64(readUInt32(cps + (i + 1) * 4)) - readUInt32(cps + i * 4);
+        if (length <= 0 || length > wordStream.size())
+            continue;
+
+        quint32 fc = readUInt32(pcds + i * 8 + 2);
+        const bool compressed = fc & 0x40000000;
+        fc &= 0x3FFFFFFF;
+
+        // Compressed pieces are stored as 8-bit characters
+        qint64 offset = compressed ? fc / 2 : fc;
+        qint64 remaining = compressed ? length : length * 2;
+
+        while (remaining > 0 && !sink.isFull()) {
+            buffer.resize(qMin<qint64>(remaining, 64 * 1024));
+            const qint64 size = reader.read(wordStream, offset, buffer.data(), buffer.size());
+            if (size <= 0)
+                break;
+
+            QString raw;
+            if (compressed)
+                raw = fromCp1252(buffer.constData(), size);
+            else
+                raw = QString::fromUtf16(reinterpret_cast<const ushort*>(buffer.constData()), size / 2);
+
+            sink.append(cleanWordText(raw, fields));
+
+            offset += size;
+            remaining -= size;
+        }
+    }
+
+    sink.finish();
+
+    result->add(Property::WordCount, sink.wordCount());
+    result->add(Property::LineCount, sink.lineCount());
+
+    return true;
+}
+
+bool OfficeExtractor::extractExcelDocument(CfbReader& reader, ExtractionResult* result)
+{
+    // Excel 95 and older use a "Book" stream with a different string format
+    const CfbReader::Stream workbookStream = reader.stream(QLatin1String("Workbook"));
+    if (!workbookStream.isValid())
+        return false;
+
+    StreamBuffer buffer(reader, workbookStream);
+
+    // The stream has to start with a BIFF8 BOF record
+    const char* bof = buffer.data(0, 6);
+    if (!bof || readUInt16(bof) != 0x0809 || readUInt16(bof + 4) != 0x0600)
+        return false;
+
+    TextSink sink(result);
+
+    // Walk all the records, only the ones containing strings are read.
+    // Numbers and formulas are skipped.
+    qint64 position = 0;
+    while (!sink.isFull()) {
+        const char* header = buffer.data(position, 4);
+        if (!header)
+            break;
+
+        const quint16 type = readUInt16(header);
+        const quint16 size = readUInt16(header + 2);
+        const qint64 dataStart = position + 4;
+        position = dataStart + size;
+
+        if (type == 0x002F) {
+            // FILEPASS, the workbook is encrypted
+            break;
+        } else if (type == 0x00FC) {
+            // SST
+            extractSharedStrings(buffer, dataStart, size, sink);
+        } else if (type == 0x0204 && size >= 9) {
+            // LABEL, a cell with an inline string
+            const char* data = buffer.data(dataStart, 9);
+            if (!data)
+                break;
+
+            ContinuedRecord record(buffer, dataStart + 9, size - 9);
+
+            QString str;
+            if (record.readString(readUInt16(data + 6), data[8] & 0x01, str) && !str.isEmpty()) {
+                sink.append(str);
+                sink.append(QLatin1String("\n"));
+            }
+        }
+    }
+
+    sink.finish();
+    return true;
+}
+
+bool OfficeExtractor::extractPowerPointDocument(CfbReader& reader, ExtractionResult* result)
+{
+    const CfbReader::Stream documentStream = reader.stream(QLatin1String("PowerPoint Document"));
+    if (!documentStream.isValid())
+        return false;
+
+    StreamBuffer buffer(reader, documentStream);
+
+    // The stream starts with the document container
+    const char* first = buffer.data(0, 8);
+    if (!first || (readUInt16(first) & 0x000F) != 0x000F)
+        return false;
+
+    TextSink sink(result);
+
+    // Incrementally saved presentations still contain the old versions of the
+    // edited slides. The current ones are found through the last edit, which
+    // the Current User stream points to.
+    const CfbReader::Stream userStream = reader.stream(QLatin1String("Current User"));
+    const QByteArray currentUser = reader.read(userStream, 0, 20);
+    bool done = false;
+
+    if (!currentUser.isEmpty() && readUInt16(currentUser.constData() + 2) == currentUserAtom) {
+        // Encrypted, there is nothing we can do
+        if (readUInt32(currentUser.constData() + 12) == encryptedDocumentToken)
+            return true;
+
+        done = appendSlideText(buffer, readUInt32(currentUser.constData() + 16), sink);
+    }
+
+    // Otherwise all the records are read in the order they are stored
+    if (!done)
+        appendRecordText(buffer, 0, buffer.size(), sink);
 
-    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
-        return QString();
-    else
-        return QString::fromUtf8(process.readAll());
+    sink.finish();
+    return true;
 }
 
 KFILEMETADATA_EXPORT_EXTRACTOR(KFileMetaData::OfficeExtractor, "kfilemetadata_officeextractor")
@@ -26,6 +26,8 @@
 namespace KFileMetaData
 {
 
+class CfbReader;
+
 class OfficeExtractor : public ExtractorPlugin
 {
 public:
@@ -35,8 +37,14 @@ public:
     virtual void extract(ExtractionResult* result);
 
 private:
-    void findExe(const QString& mimeType, const QString& name, QString& fullPath);
-    QString textFromFile(const QString& fileUrl, const QString& command, QStringList& arguments);
+    void textFromFile(const QString& fileUrl, const QString& command, QStringList& arguments,
+                      ExtractionResult* result, bool addStatistics);
+
+    void extractSummaryInformation(CfbReader& reader, ExtractionResult* result, bool includeStatistics);
+
+    bool extractWordDocument(CfbReader& reader, ExtractionResult* result);
+    bool extractExcelDocument(CfbReader& reader, ExtractionResult* result);
+    bool extractPowerPointDocument(CfbReader& reader, ExtractionResult* result);
 
 private:
     QStringList m_available_mime_types;
@@ -0,0 +1,116 @@
+/*
+    Extraction of the text of several parts of a document in parallel
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PART_EXTRACTION_H
+#define PART_EXTRACTION_H
+
+#include "extractionresult.h"
+
+#include <QStringList>
+#include <QtConcurrentMap>
+
+namespace KFileMetaData
+{
+
+/**
+ * Passes everything on to another ExtractionResult and counts the
+ * characters of the text, so that the text budget can be checked
+ */
+class TextCountingResult : public ExtractionResult
+{
+public:
+    explicit TextCountingResult(ExtractionResult* result)
+        : ExtractionResult(*result)
+        , m_result(result)
+        , m_size(0)
+    {
+    }
+
+    virtual void append(const QString& text)
+    {
+        m_size += text.size();
+        m_result->append(text);
+    }
+
+    virtual void add(Property::Property property, const QVariant& value)
+    {
+        m_result->add(property, value);
+    }
+
+    virtual void addType(Type::Type type)
+    {
+        m_result->addType(type);
+    }
+
+    /**
+     * Returns true once the text budget of the result has been used up
+     */
+    bool isFull() const
+    {
+        return textBudget() > 0 && m_size >= textBudget();
+    }
+
+private:
+    ExtractionResult* m_result;
+    int m_size;
+};
+
+/**
+ * Appends the text of all the \p parts to \p result in the given order,
+ * eg - the chapters of a book or the slides of a presentation. No further
+ * parts are converted once the text budget of the result has been used up.
+ *
+ * If the result allows it, the parts are converted in parallel, a few at a
+ * time so that only their text has to be kept in memory. The \p converter
+ * then returns the text of a single part from operator(), which is called
+ * from several threads. Otherwise the text of each part is streamed to the
+ * result by converter.extract(part, result).
+ */
+template<typename Converter>
+void extractParts(const QStringList& parts, const Converter& converter, ExtractionResult* result)
+{
+    TextCountingResult counter(result);
+
+    const int parallelism = result->parallelism();
+    if (parallelism <= 1 || parts.size() <= 1) {
+        foreach (const QString& part, parts) {
+            if (counter.isFull())
+                return;
+            converter.extract(part, &counter);
+        }
+        return;
+    }
+
+    for (int i = 0; i < parts.size() && !counter.isFull(); i += parallelism) {
+        const QStringList batch = parts.mid(i, parallelism);
+        const QStringList texts = QtConcurrent::blockingMapped<QStringList>(batch, converter);
+
+        foreach (const QString& text, texts) {
+            if (counter.isFull())
+                return;
+            if (!text.isEmpty())
+                counter.append(text);
+        }
+    }
+}
+
+}
+
+#endif // PART_EXTRACTION_H
@@ -0,0 +1,626 @@
+/*
+    Reader for the document information of PDF files
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "pdfinforeader.h"
+
+#include <QSet>
+
+#include <limits.h>
+#include <string.h>
+
+using namespace KFileMetaData;
+
+namespace
+{
+// How far from the end of the file "startxref" is looked for
+const int maxTailSize = 1024;
+
+// Incremental updates each add a cross reference table
+const int maxXrefTables = 64;
+
+// Dictionaries and arrays nested deeper than this are not parsed
+const int maxNesting = 32;
+
+const int maxMetadataSize = 1024 * 1024;
+
+// PDFDocEncoding is Latin-1, except for the range 0x80 - 0xA0
+const ushort pdfDocEncoding[] = {
+    0x2022, 0x2020, 0x2021, 0x2026, 0x2014, 0x2013, 0x0192, 0x2044,
+    0x2039, 0x203A, 0x2212, 0x2030, 0x201E, 0x201C, 0x201D, 0x2018,
+    0x2019, 0x201A, 0x2122, 0xFB01, 0xFB02, 0x0141, 0x0152, 0x0160,
+    0x0178, 0x017D, 0x0131, 0x0142, 0x0153, 0x0161, 0x017E, 0xFFFD,
+    0x20AC
+};
+
+struct Value {
+    enum Type {
+        Null,
+        Number,
+        String,
+        Name,
+        Reference,
+        Other
+    };
+
+    Value()
+        : type(Null)
+        , number(0)
+    {
+    }
+
+    Type type;
+    QByteArray string;
+    qint64 number;
+};
+
+// Nested dictionaries and arrays are only skipped, they are never needed
+typedef QHash<QByteArray, Value> Dictionary;
+
+inline bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0';
+}
+
+inline bool isDelimiter(char c)
+{
+    return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' || c == ']' ||
+           c == '{' || c == '}' || c == '/' || c == '%';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Parses the objects of a PDF file. Every read function returns false
+ * if the data is not what it expects, or runs past the end.
+ */
+class Lexer
+{
+public:
+    Lexer(const char* data, qint64 size)
+        : m_data(data)
+        , m_size(size)
+        , m_position(0)
+    {
+    }
+
+    qint64 position() const
+    {
+        return m_position;
+    }
+
+    void seek(qint64 position)
+    {
+        m_position = position;
+    }
+
+    void skipWhitespace()
+    {
+        while (m_position < m_size) {
+            const char c = m_data[m_position];
+            if (c == '%') {
+                while (m_position < m_size && m_data[m_position] != '\n' && m_data[m_position] != '\r')
+                    m_position++;
+            } else if (isWhitespace(c)) {
+                m_position++;
+            } else {
+                break;
+            }
+        }
+    }
+
+    bool readKeyword(const char* keyword)
+    {
+        skipWhitespace();
+
+        const int length = strlen(keyword);
+        if (m_position + length > m_size || memcmp(m_data + m_position, keyword, length) != 0)
+            return false;
+
+        // "trailer" must not match the start of "trailers"
+        if (m_position + length < m_size) {
+            const char next = m_data[m_position + length];
+            if (!isWhitespace(next) && !isDelimiter(next))
+                return false;
+        }
+
+        m_position += length;
+        return true;
+    }
+
+    bool readInteger(qint64* number)
+    {
+        skipWhitespace();
+
+        const qint64 start = m_position;
+        qint64 value = 0;
+        while (m_position < m_size && isDigit(m_data[m_position]) && m_position - start < 18) {
+            value = value * 10 + (m_data[m_position] - '0');
+            m_position++;
+        }
+
+        if (m_position == start)
+            return false;
+
+        *number = value;
+        return true;
+    }
+
+    /**
+     * Reads "number generation obj" and checks that it is object \p number
+     */
+    bool readObjectHeader(int number)
+    {
+        qint64 objectNumber;
+        qint64 generation;
+        return readInteger(&objectNumber) && objectNumber == number &&
+               readInteger(&generation) && readKeyword("obj");
+    }
+
+    bool readDictionary(Dictionary* dictionary)
+    {
+        return readDictionary(dictionary, 0);
+    }
+
+    bool readValue(Value* value)
+    {
+        return readValue(value, 0);
+    }
+
+private:
+    bool readDictionary(Dictionary* dictionary, int depth)
+    {
+        skipWhitespace();
+        if (!readDelimiter("<<"))
+            return false;
+
+        while (true) {
+            skipWhitespace();
+            if (m_position + 1 < m_size && m_data[m_position] == '>' && m_data[m_position + 1] == '>') {
+                m_position += 2;
+                return true;
+            }
+
+            Value key;
+            if (!readValue(&key, depth + 1) || key.type != Value::Name)
+                return false;
+
+            Value value;
+            if (!readValue(&value, depth + 1))
+                return false;
+
+            if (dictionary)
+                dictionary->insert(key.string, value);
+        }
+    }
+
+    bool readDelimiter(const char* delimiter)
+    {
+        const int length = strlen(delimiter);
+        if (m_position + length > m_size || memcmp(m_data + m_position, delimiter, length) != 0)
+            return false;
+
+        m_position += length;
+        return true;
+    }
+
+    bool readValue(Value* value, int depth)
+    {
+        if (depth > maxNesting)
+            return false;
+
+        skipWhitespace();
+        if (m_position >= m_size)
+            return false;
+
+        const char c = m_data[m_position];
+        if (c == '/') {
+            m_position++;
+            value->type = Value::Name;
+            value->string = readRegular();
+            return true;
+        } else if (c == '(') {
+            m_position++;
+            value->type = Value::String;
+            return readLiteralString(&value->string);
+        } else if (c == '<') {
+            if (m_position + 1 < m_size && m_data[m_position + 1] == '<') {
+                value->type = Value::Other;
+                return readDictionary(0, depth);
+            }
+            m_position++;
+            value->type = Value::String;
+            return readHexString(&value->string);
+        } else if (c == '[') {
+            m_position++;
+            value->type = Value::Other;
+            while (true) {
+                skipWhitespace();
+                if (m_position >= m_size)
+                    return false;
+                if (m_data[m_position] == ']') {
+                    m_position++;
+                    return true;
+                }
+
+                Value element;
+                if (!readValue(&element, depth + 1))
+                    return false;
+            }
+        } else if (isDigit(c) || c == '-' || c == '+' || c == '.') {
+            return readNumberOrReference(value);
+        }
+
+        // true, false and null
+        const QByteArray keyword = readRegular();
+        if (keyword.isEmpty())
+            return false;
+
+        value->type = (keyword == "null") ? Value::Null : Value::Other;
+        return true;
+    }
+
+    QByteArray readRegular()
+    {
+        const qint64 start = m_position;
+        while (m_position < m_size && !isWhitespace(m_data[m_position]) && !isDelimiter(m_data[m_position]))
+            m_position++;
+
+        return QByteArray(m_data + start, m_position - start);
+    }
+
+    bool readNumberOrReference(Value* value)
+    {
+        const QByteArray token = readRegular();
+
+        bool ok = false;
+        value->type = Value::Number;
+        value->number = token.toLongLong(&ok);
+        if (!ok) {
+            // Real numbers are never needed
+            value->type = Value::Other;
+            return true;
+        }
+
+        // "12 0 R" is a reference to object 12
+        const qint64 afterNumber = m_position;
+        qint64 generation;
+        if (readInteger(&generation) && readKeyword("R")) {
+            value->type = Value::Reference;
+            return true;
+        }
+
+        m_position = afterNumber;
+        return true;
+    }
+
+    bool readLiteralString(QByteArray* string)
+    {
+        int nesting = 0;
+        while (m_position < m_size) {
+            char c = m_data[m_position++];
+
+            if (c == '(') {
+                nesting++;
+            } else if (c == ')') {
+                if (nesting == 0)
+                    return true;
+                nesting--;
+            } else if (c == '\\') {
+                if (m_position >= m_size)
+                    return false;
+
+                c = m_data[m_position++];
+                switch (c) {
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case '\r':
+                    // A backslash at the end of a line continues the string
+                    if (m_position < m_size && m_data[m_position] == '\n')
+                        m_position++;
+                    continue;
+                case '\n':
+                    continue;
+                default:
+                    if (c >= '0' && c <= '7') {
+                        int octal = c - '0';
+                        for (int i = 0; i < 2 && m_position < m_size && m_data[m_position] >= '0' && m_data[m_position] <= '7'; i++)
+                            octal = octal * 8 + (m_data[m_position++] - '0');
+                        c = octal;
+                    }
+                    break;
+                }
+            }
+
+            string->append(c);
+        }
+
+        return false;
+    }
+
+    bool readHexString(QByteArray* string)
+    {
+        int high = -1;
+        while (m_position < m_size) {
+            const char c = m_data[m_position++];
+            if (c == '>') {
+                // An odd number of digits is padded with a zero
+                if (high != -1)
+                    string->append(high << 4);
+                return true;
+            }
+
+            const int digit = hexValue(c);
+            if (digit == -1)
+                continue;
+
+            if (high == -1) {
+                high = digit;
+            } else {
+                string->append((high << 4) | digit);
+                high = -1;
+            }
+        }
+
+        return false;
+    }
+
+    const char* m_data;
+    qint64 m_size;
+    qint64 m_position;
+};
+
+QString decodeTextString(const QByteArray& string)
+{
+    // Text strings are either UTF-16 or, since PDF 2.0, UTF-8 with a byte order
+    // mark, or PDFDocEncoding
+    if (string.size() >= 3 && uchar(string[0]) == 0xEF && uchar(string[1]) == 0xBB && uchar(string[2]) == 0xBF)
+        return QString::fromUtf8(string.constData() + 3, string.size() - 3);
+
+    if (string.size() >= 2 && uchar(string[0]) == 0xFE && uchar(string[1]) == 0xFF) {
+        QString text;
+        text.reserve(string.size() / 2);
+        for (int i = 2; i + 1 < string.size(); i += 2)
+            text.append(QChar(ushort((uchar(string[i]) << 8) | uchar(string[i + 1]))));
+        return text;
+    }
+
+    QString text;
+    text.reserve(string.size());
+    for (int i = 0; i < string.size(); i++) {
+        const uchar c = string[i];
+        if (c >= 0x80 && c <= 0xA0)
+            text.append(QChar(pdfDocEncoding[c - 0x80]));
+        else
+            text.append(QChar(c));
+    }
+    return text;
+}
+
+/**
+ * Moves \p lexer to the start of the object which \p value refers to
+ */
+bool seekObject(Lexer& lexer, const QHash<int, qint64>& offsets, const Value& value)
+{
+    if (value.type != Value::Reference || value.number > INT_MAX)
+        return false;
+
+    const int number = value.number;
+    QHash<int, qint64>::const_iterator it = offsets.constFind(number);
+    if (it == offsets.constEnd() || it.value() <= 0)
+        return false;
+
+    lexer.seek(it.value());
+    return lexer.readObjectHeader(number);
+}
+}
+
+PdfInfoReader::PdfInfoReader(const QString& fileName)
+    : m_file(fileName)
+    , m_data(0)
+    , m_size(0)
+    , m_pageCount(0)
+    , m_valid(false)
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+
+    m_size = m_file.size();
+    if (m_size <= 0)
+        return;
+
+    // Only the pages which are looked at are read from the disk
+    m_data = reinterpret_cast<const char*>(m_file.map(0, m_size));
+    if (!m_data)
+        return;
+
+    m_valid = read();
+
+    m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+    m_data = 0;
+    m_file.close();
+}
+
+PdfInfoReader::~PdfInfoReader()
+{
+}
+
+bool PdfInfoReader::isValid() const
+{
+    return m_valid;
+}
+
+QString PdfInfoReader::info(const QString& key) const
+{
+    return m_info.value(key);
+}
+
+int PdfInfoReader::pageCount() const
+{
+    return m_pageCount;
+}
+
+QByteArray PdfInfoReader::metadata() const
+{
+    return m_metadata;
+}
+
+bool PdfInfoReader::read()
+{
+    Lexer lexer(m_data, m_size);
+
+    // The offset of the last cross reference table follows "startxref" at the end of the file
+    const qint64 tailStart = qMax<qint64>(0, m_size - maxTailSize);
+    const QByteArray tail = QByteArray::fromRawData(m_data + tailStart, m_size - tailStart);
+    const int startXref = tail.lastIndexOf("startxref");
+    if (startXref == -1)
+        return false;
+
+    lexer.seek(tailStart + startXref + 9);
+    qint64 xrefOffset;
+    if (!lexer.readInteger(&xrefOffset))
+        return false;
+
+    // Follow the chain of incremental updates. The newest table comes first
+    // and its entries replace those of the older ones.
+    Dictionary trailer;
+    QSet<qint64> visited;
+    while (visited.size() < maxXrefTables) {
+        if (xrefOffset <= 0 || xrefOffset >= m_size || visited.contains(xrefOffset))
+            return false;
+        visited.insert(xrefOffset);
+
+        // Cross reference streams need zlib and mean that objects are compressed
+        lexer.seek(xrefOffset);
+        if (!lexer.readKeyword("xref"))
+            return false;
+
+        while (true) {
+            qint64 first;
+            qint64 count;
+            if (!lexer.readInteger(&first))
+                break;
+            if (!lexer.readInteger(&count) || count > (m_size - lexer.position()) / 18 || first > INT_MAX - count)
+                return false;
+
+            for (qint64 i = 0; i < count; i++) {
+                qint64 offset;
+                qint64 generation;
+                if (!lexer.readInteger(&offset) || !lexer.readInteger(&generation))
+                    return false;
+
+                lexer.skipWhitespace();
+                const bool inUse = lexer.readKeyword("n");
+                if (!inUse && !lexer.readKeyword("f"))
+                    return false;
+
+                // An object which a newer table marks as free has been deleted, its
+                // offset in the older tables must not be used
+                const int number = first + i;
+                if (!m_offsets.contains(number))
+                    m_offsets.insert(number, inUse ? offset : 0);
+            }
+        }
+
+        Dictionary dictionary;
+        if (!lexer.readKeyword("trailer") || !lexer.readDictionary(&dictionary))
+            return false;
+
+        if (dictionary.contains("Encrypt") || dictionary.contains("XRefStm"))
+            return false;
+
+        if (trailer.isEmpty())
+            trailer = dictionary;
+
+        const Value prev = dictionary.value("Prev");
+        if (prev.type != Value::Number)
+            break;
+        xrefOffset = prev.number;
+    }
+
+    // The Info dictionary is optional, but if there is one it has to be readable
+    const Value infoReference = trailer.value("Info");
+    if (infoReference.type != Value::Null) {
+        Dictionary info;
+        if (!seekObject(lexer, m_offsets, infoReference) || !lexer.readDictionary(&info))
+            return false;
+
+        Dictionary::const_iterator it = info.constBegin();
+        for (; it != info.constEnd(); ++it) {
+            if (it.value().type == Value::String)
+                m_info.insert(QString::fromLatin1(it.key()), decodeTextString(it.value().string));
+        }
+    }
+
+    Dictionary catalog;
+    if (!seekObject(lexer, m_offsets, trailer.value("Root")) || !lexer.readDictionary(&catalog))
+        return false;
+
+    Dictionary pages;
+    if (!seekObject(lexer, m_offsets, catalog.value("Pages")) || !lexer.readDictionary(&pages))
+        return false;
+
+    const Value count = pages.value("Count");
+    if (count.type != Value::Number || count.number < 0 || count.number > INT_MAX)
+        return false;
+    m_pageCount = count.number;
+
+    // The XMP packet is only used if it is not compressed, which it rarely is
+    Dictionary metadata;
+    if (seekObject(lexer, m_offsets, catalog.value("Metadata")) && lexer.readDictionary(&metadata) &&
+            !metadata.contains("Filter") && lexer.readKeyword("stream")) {
+        Value length = metadata.value("Length");
+        if (length.type == Value::Reference) {
+            const qint64 streamKeywordEnd = lexer.position();
+            if (!seekObject(lexer, m_offsets, length) || !lexer.readValue(&length))
+                length = Value();
+            lexer.seek(streamKeywordEnd);
+        }
+
+        // The data starts after the end of line which follows "stream"
+        qint64 start = lexer.position();
+        if (start < m_size && m_data[start] == '\r')
+            start++;
+        if (start < m_size && m_data[start] == '\n')
+            start++;
+
+        if (length.type == Value::Number && length.number > 0 && length.number <= maxMetadataSize &&
+                start + length.number <= m_size)
+            m_metadata = QByteArray(m_data + start, length.number);
+    }
+
+    return true;
+}
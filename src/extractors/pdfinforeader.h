@@ -0,0 +1,85 @@
+/*
+    Reader for the document information of PDF files
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef PDF_INFO_READER_H
+#define PDF_INFO_READER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+namespace KFileMetaData
+{
+
+/**
+ * \class PdfInfoReader pdfinforeader.h
+ *
+ * \brief Reads the document information of a PDF file without loading
+ * the document.
+ *
+ * Only the trailer and the cross reference tables at the end of the file
+ * are parsed, and only the objects which are needed are looked up: the
+ * Info dictionary, the page tree root and the XMP metadata stream.
+ *
+ * Files which are encrypted, damaged or which keep these objects in
+ * compressed object streams are not handled, isValid() is then false and
+ * the document has to be loaded by Poppler instead.
+ */
+class PdfInfoReader
+{
+public:
+    explicit PdfInfoReader(const QString& fileName);
+    ~PdfInfoReader();
+
+    bool isValid() const;
+
+    /**
+     * Returns the value of the entry \p key of the Info dictionary, eg -
+     * "Title", in the same way as Poppler::Document::info()
+     */
+    QString info(const QString& key) const;
+
+    int pageCount() const;
+
+    /**
+     * The XMP packet of the document, if it is stored uncompressed
+     */
+    QByteArray metadata() const;
+
+private:
+    bool read();
+
+    QFile m_file;
+    const char* m_data;
+    qint64 m_size;
+
+    // The offset of each object, 0 for the ones which have been deleted
+    QHash<int, qint64> m_offsets;
+
+    QHash<QString, QString> m_info;
+    int m_pageCount;
+    QByteArray m_metadata;
+    bool m_valid;
+};
+
+}
+
+#endif // PDF_INFO_READER_H
@@ -19,6 +19,7 @@
 
 
 #include "plaintextextractor.h"
+#include <QCryptographicHash>
 #include <QFile>
 
 #include <fstream>
@@ -31,6 +32,30 @@ PlainTextExtractor::PlainTextExtractor(QObject* parent, const QVariantList&)
 
 }
 
+namespace
+{
+// The number of bytes at the end of the processed data which are hashed
+// in order to verify that a file has only been appended to
+const qint64 tailHashSize = 4096;
+
+QByteArray tailHash(std::ifstream& fstream, qint64 end)
+{
+    const qint64 start = qMax<qint64>(0, end - tailHashSize);
+
+    QByteArray tail;
+    tail.resize(end - start);
+
+    fstream.clear();
+    fstream.seekg(start);
+    if (!fstream.read(tail.data(), tail.size())) {
+        fstream.clear();
+        return QByteArray();
+    }
+
+    return QCryptographicHash::hash(tail, QCryptographicHash::Sha1);
+}
+}
+
 QStringList PlainTextExtractor::mimetypes() const
 {
     return QStringList() << QLatin1String("text/");
@@ -46,15 +71,48 @@ void PlainTextExtractor::extract(ExtractionResult* result)
         return;
     }
 
+    // If the file has only been appended to since the last extraction
+    // we just need to process the new data
+    const bool trackAppends = result->hasAppendState() ||
+                              (result->inputFlags() & ExtractionResult::ExtractAppendState);
+
+    qint64 offset = 0;
+    if (result->hasAppendState()) {
+        fstream.seekg(0, std::ios::end);
+        const qint64 fileSize = fstream.tellg();
+        const qint64 previousSize = result->appendStateSize();
+
+        if (previousSize > 0 && previousSize <= fileSize &&
+                tailHash(fstream, previousSize) == result->appendStateTailHash()) {
+            offset = previousSize;
+            lines = result->appendStateLineCount();
+        }
+        fstream.clear();
+        fstream.seekg(offset);
+    }
+
+    // A trailing line without a newline is not part of the stored state
+    // as it could still be continued. It is processed again next time.
+    qint64 completeSize = offset;
+    int completeLines = lines;
+
     while (std::getline(fstream, line)) {
         QByteArray arr = QByteArray::fromRawData(line.c_str(), line.size());
         result->append(QString::fromUtf8(arr));
 
         lines += 1;
+        if (!fstream.eof()) {
+            completeSize += line.size() + 1;
+            completeLines = lines;
+        }
     }
 
     result->add(Property::LineCount, lines);
     result->addType(Type::Text);
+
+    if (trackAppends) {
+        result->setAppendState(completeSize, completeLines, tailHash(fstream, completeSize));
+    }
 }
 
 KFILEMETADATA_EXPORT_EXTRACTOR(KFileMetaData::PlainTextExtractor, "kfilemetadata_plaintextextractor")
@@ -20,15 +20,119 @@
 
 
 #include "popplerextractor.h"
+#include "pdfinforeader.h"
+#include "xmpreader.h"
 
 #include <KDebug>
+#include <QFuture>
 #include <QScopedPointer>
+#include <QtConcurrentRun>
 
 #include <algorithm>
 #include <functional>
 
 using namespace KFileMetaData;
 
+namespace
+{
+// The title extracted from the pdf metadata is in many cases not the real title
+// of the document. Especially for research papers that are exported to pdf.
+// As mostly the title of a pdf document is written on the first page in the biggest font
+// we use this if the pdfDoc title is considered junk
+bool isJunkTitle(const QString& title)
+{
+    // It is very unlikely that the title of a document only contains one word. Most
+    // research papers i found written with microsoft word have a garbage title of the
+    // pdf creator rather than the real document title.
+    return title.isEmpty() ||
+           !title.contains(' ') ||
+           title.contains(QLatin1String("Microsoft"), Qt::CaseInsensitive);
+}
+
+/**
+ * Returns the title of the XMP packet, or else the one of the Info dictionary.
+ * \p document is either a Poppler::Document or a PdfInfoReader.
+ */
+template<typename Document>
+QString documentTitle(const Document& document, const XmpReader& xmp)
+{
+    const QVariantList titles = xmp.values(Property::Title);
+    if (!titles.isEmpty())
+        return titles.first().toString().trimmed();
+
+    return document.info(QLatin1String("Title")).trimmed();
+}
+
+/**
+ * Adds the document information other than the title. The values of the
+ * XMP packet take precedence over the entries of the Info dictionary.
+ */
+template<typename Document>
+void addDocumentInfo(const Document& document, const XmpReader& xmp, int pageCount, ExtractionResult* result)
+{
+    foreach (Property::Property property, xmp.properties()) {
+        if (property == Property::Title)
+            continue;
+
+        foreach (const QVariant& value, xmp.values(property))
+            result->add(property, value);
+    }
+
+    QString subject = document.info(QLatin1String("Subject"));
+    if (!subject.isEmpty()) {
+        result->add(Property::Subject, subject);
+    }
+
+    QString author = document.info(QLatin1String("Author"));
+    if (!author.isEmpty() && !xmp.contains(Property::Author)) {
+        result->add(Property::Author, author);
+    }
+
+    QString creator = document.info(QLatin1String("Creator"));
+    if (!creator.isEmpty()) {
+        result->add(Property::Creator, creator);
+    }
+
+    if (pageCount > 0) {
+        result->add(Property::PageCount, pageCount);
+    }
+}
+
+// Documents with fewer pages than this per thread are not split up
+const int minPagesPerThread = 16;
+
+struct PageTexts {
+    QStringList texts;
+    bool complete;
+};
+
+/**
+ * Returns the text of the pages [first, last) of the PDF \p fileUrl.
+ * A Poppler::Document cannot be used by several threads at the same
+ * time, so every range loads a document of its own.
+ */
+PageTexts extractPageRange(const QString& fileUrl, int first, int last, Poppler::Page::TextLayout layout)
+{
+    PageTexts pageTexts;
+    pageTexts.complete = false;
+
+    QScopedPointer<Poppler::Document> pdfDoc(Poppler::Document::load(fileUrl, 0, 0));
+    if (!pdfDoc || pdfDoc->isLocked())
+        return pageTexts;
+
+    for (int i = first; i < last; i++) {
+        QScopedPointer<Poppler::Page> page(pdfDoc->page(i));
+        if (!page)
+            return pageTexts;
+
+        pageTexts.texts << page->text(QRectF(), layout);
+    }
+
+    pageTexts.complete = true;
+    return pageTexts;
+}
+}
+
 PopplerExtractor::PopplerExtractor(QObject* parent, const QVariantList&)
     : ExtractorPlugin(parent)
 {
@@ -47,6 +151,24 @@ QStringList PopplerExtractor::mimetypes() const
 void PopplerExtractor::extract(ExtractionResult* result)
 {
     const QString fileUrl = result->inputUrl();
+    const bool extractMetaData = result->inputFlags() & ExtractionResult::ExtractMetaData;
+    const bool extractText = result->inputFlags() & ExtractionResult::ExtractPlainText;
+
+    // Without the text, the document information can usually be read with a few
+    // seeks instead of loading the document. Poppler is still needed for broken
+    // or encrypted files, and to look for the title on the first page.
+    if (extractMetaData && !extractText) {
+        PdfInfoReader reader(fileUrl);
+        const XmpReader xmp(reader.metadata());
+        const QString title = documentTitle(reader, xmp);
+        if (reader.isValid() && !isJunkTitle(title)) {
+            result->addType(Type::Document);
+            result->add(Property::Title, title);
+            addDocumentInfo(reader, xmp, reader.pageCount(), result);
+            return;
+        }
+    }
+
     QScopedPointer<Poppler::Document> pdfDoc(Poppler::Document::load(fileUrl, 0, 0));
 
     if (!pdfDoc || pdfDoc->isLocked()) {
@@ -55,58 +177,97 @@ void PopplerExtractor::extract(ExtractionResult* result)
 
     result->addType(Type::Document);
 
-    QString title = pdfDoc->info(QLatin1String("Title")).trimmed();
+    QString title;
+    bool titleFromFirstPage = false;
 
-    // The title extracted from the pdf metadata is in many cases not the real title
-    // of the document. Especially for research papers that are exported to pdf.
-    // As mostly the title of a pdf document is written on the first page in the biggest font
-    // we use this if the pdfDoc title is considered junk
-    if (title.isEmpty() ||
-            !title.contains(' ') ||                        // very unlikely the title of a document does only contain one word.
-            title.contains(QLatin1String("Microsoft"), Qt::CaseInsensitive)) {  // most research papers i found written with microsoft word
-        // have a garbage title of the pdf creator rather than the real document title
-        title = parseFirstPage(pdfDoc.data(), fileUrl);
-    }
+    if (extractMetaData) {
+        const XmpReader xmp(pdfDoc->metadata().toUtf8());
 
-    if (!title.isEmpty()) {
-        result->add(Property::Title, title);
+        title = documentTitle(*pdfDoc, xmp);
+        if (isJunkTitle(title)) {
+            title.clear();
+            titleFromFirstPage = true;
+        }
+
+        addDocumentInfo(*pdfDoc, xmp, pdfDoc->numPages(), result);
     }
 
-    QString subject = pdfDoc->info(QLatin1String("Subject"));
-    if (!subject.isEmpty()) {
-        result->add(Property::Subject, title);
+    // The title heuristic needs the text boxes of the first page. The page is
+    // kept for its text, the boxes are released as soon as the title is known.
+    QScopedPointer<Poppler::Page> firstPage;
+    if (titleFromFirstPage) {
+        firstPage.reset(pdfDoc->page(0));
+        if (!firstPage) {
+            kWarning() << "Could not read page content from" << fileUrl;
+            return;
+        }
+
+        const QList<Poppler::TextBox*> textBoxes = firstPage->textList();
+        title = titleFromTextBoxes(textBoxes);
+        qDeleteAll(textBoxes);
     }
 
-    QString author = pdfDoc->info(QLatin1String("Author"));
-    if (!author.isEmpty()) {
-        result->add(Property::Author, author);
+    if (!title.isEmpty()) {
+        result->add(Property::Title, title);
     }
 
-    QString creator = pdfDoc->info(QLatin1String("Creator"));
-    if (!author.isEmpty()) {
-        result->add(Property::Creator, creator);
+    if (!extractText)
+        return;
+
+    // The physical layout puts the text in reading order, which is expensive
+    // and not needed when only the words matter
+    const Poppler::Page::TextLayout layout = (result->inputFlags() & ExtractionResult::ExtractRawOrderText)
+                                             ? Poppler::Page::RawOrderLayout
+                                             : Poppler::Page::PhysicalLayout;
+
+    const int pageCount = pdfDoc->numPages();
+    const int threads = qMin(result->parallelism(), pageCount / minPagesPerThread);
+    if (threads > 1) {
+        firstPage.reset();
+        extractTextInParallel(fileUrl, pageCount, threads, layout, result);
+        return;
     }
 
-    for (int i = 0; i < pdfDoc->numPages(); i++) {
-        QScopedPointer<Poppler::Page> page(pdfDoc->page(i));
+    for (int i = 0; i < pageCount; i++) {
+        QScopedPointer<Poppler::Page> page(i == 0 && firstPage ? firstPage.take() : pdfDoc->page(i));
         if (!page) { // broken pdf files do not return a valid page
             kWarning() << "Could not read page content from" << fileUrl;
             break;
         }
-        result->append(page->text(QRectF()));
+        result->append(page->text(QRectF(), layout));
     }
 }
 
-QString PopplerExtractor::parseFirstPage(Poppler::Document* pdfDoc, const QString& fileUrl)
+void PopplerExtractor::extractTextInParallel(const QString& fileUrl, int pageCount, int threads,
+                                             Poppler::Page::TextLayout layout, ExtractionResult* result)
 {
-    QScopedPointer<Poppler::Page> p(pdfDoc->page(0));
+    // Every thread gets a contiguous range of pages, the first range is appended
+    // as soon as it is done while the others are still being extracted
+    const int rangeSize = (pageCount + threads - 1) / threads;
+
+    QList< QFuture<PageTexts> > futures;
+    for (int first = 0; first < pageCount; first += rangeSize)
+        futures << QtConcurrent::run(extractPageRange, fileUrl, first, qMin(first + rangeSize, pageCount), layout);
+
+    bool complete = true;
+    foreach (const QFuture<PageTexts>& future, futures) {
+        const PageTexts pageTexts = future.result();
+        if (!complete)
+            continue;
+
+        foreach (const QString& text, pageTexts.texts)
+            result->append(text);
 
-    if (!p) {
-        kWarning() << "Could not read page content from" << fileUrl;
-        return QString();
+        // Like the sequential extraction, stop at the first broken page
+        if (!pageTexts.complete) {
+            kWarning() << "Could not read page content from" << fileUrl;
+            complete = false;
+        }
     }
+}
 
-    QList<Poppler::TextBox*> tbList = p->textList();
+QString PopplerExtractor::titleFromTextBoxes(const QList<Poppler::TextBox*>& textBoxes)
+{
     QMap<int, QString> possibleTitleMap;
 
     int currentLargestChar = 0;
@@ -115,8 +276,7 @@ QString PopplerExtractor::parseFirstPage(Poppler::Document* pdfDoc, const QStrin
     // Iterate over all textboxes. Each textbox can be a single character/word or textblock
     // Here we combine the etxtboxes back together based on the textsize
     // Important are the words with the biggest font size
-    foreach(Poppler::TextBox * tb, tbList) {
-
+    foreach(Poppler::TextBox * tb, textBoxes) {
         // if we added followup words, skip the textboxes here now
         if (skipTextboxes > 0) {
             skipTextboxes--;
@@ -148,8 +308,6 @@ QString PopplerExtractor::parseFirstPage(Poppler::Document* pdfDoc, const QStrin
         }
     }
 
-    qDeleteAll(tbList);
-
     QList<int> titleSizes = possibleTitleMap.keys();
     std::sort(titleSizes.begin(), titleSizes.end(), std::greater<int>());
 
@@ -36,7 +36,9 @@ public:
     virtual void extract(ExtractionResult* result);
 
 private:
-    QString parseFirstPage(Poppler::Document* pdfDoc, const QString& fileUrl);
+    QString titleFromTextBoxes(const QList<Poppler::TextBox*>& textBoxes);
+    void extractTextInParallel(const QString& fileUrl, int pageCount, int threads,
+                               Poppler::Page::TextLayout layout, ExtractionResult* result);
 };
 }
 
@@ -0,0 +1,116 @@
+/*
+    Helpers for building UTF-8 text out of markup
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "utf8text.h"
+
+namespace
+{
+// Text which does not contain any whitespace is only split once it gets this large
+const int maxWordSize = 1024 * 1024;
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+}
+
+namespace KFileMetaData
+{
+
+void appendUtf8(QByteArray& text, uint codePoint)
+{
+    if (codePoint < 0x80) {
+        text.append(char(codePoint));
+    } else if (codePoint < 0x800) {
+        text.append(char(0xC0 | (codePoint >> 6)));
+        text.append(char(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        text.append(char(0xE0 | (codePoint >> 12)));
+        text.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+        text.append(char(0x80 | (codePoint & 0x3F)));
+    } else {
+        text.append(char(0xF0 | (codePoint >> 18)));
+        text.append(char(0x80 | ((codePoint >> 12) & 0x3F)));
+        text.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+        text.append(char(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool decodeCharacterReference(const QByteArray& name, uint* codePoint)
+{
+    if (name.startsWith('#')) {
+        bool ok = false;
+        if (name.size() > 1 && (name[1] == 'x' || name[1] == 'X'))
+            *codePoint = name.mid(2).toUInt(&ok, 16);
+        else
+            *codePoint = name.mid(1).toUInt(&ok, 10);
+
+        return ok && *codePoint > 0 && *codePoint <= 0x10FFFF &&
+               (*codePoint < 0xD800 || *codePoint > 0xDFFF);
+    }
+
+    if (name == "amp")
+        *codePoint = '&';
+    else if (name == "lt")
+        *codePoint = '<';
+    else if (name == "gt")
+        *codePoint = '>';
+    else if (name == "quot")
+        *codePoint = '"';
+    else if (name == "apos")
+        *codePoint = '\'';
+    else
+        return false;
+
+    return true;
+}
+
+QString takeCompleteWords(QByteArray& text, bool all)
+{
+    int end = text.size();
+
+    if (!all) {
+        int space = end - 1;
+        while (space >= 0 && !isSpace(text.at(space)))
+            space--;
+
+        if (space >= 0) {
+            end = space + 1;
+        } else if (end > maxWordSize) {
+            // Do not split a UTF-8 sequence
+            while (end > 0 && (text.at(end - 1) & 0xC0) == 0x80)
+                end--;
+            if (end > 0 && (text.at(end - 1) & 0xC0) == 0xC0)
+                end--;
+        } else {
+            return QString();
+        }
+    }
+
+    if (end == 0)
+        return QString();
+
+    const QString words = QString::fromUtf8(text.constData(), end).trimmed();
+    text.remove(0, end);
+
+    return words;
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+    Helpers for building UTF-8 text out of markup
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef UTF8_TEXT_H
+#define UTF8_TEXT_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace KFileMetaData
+{
+
+/**
+ * Appends the UTF-8 encoding of \p codePoint to \p text
+ */
+void appendUtf8(QByteArray& text, uint codePoint);
+
+/**
+ * Decodes the character reference \p name, the part between '&' and ';'.
+ * Numeric references and the five entities predefined by XML are known.
+ * Returns false if \p name is not one of them.
+ */
+bool decodeCharacterReference(const QByteArray& name, uint* codePoint);
+
+/**
+ * Removes the complete words at the start of the UTF-8 \p text and
+ * returns them, the last word could still be continued by the next
+ * chunk of data. Words which get very large are split anyway. If \p all
+ * is set, all of the text is returned.
+ */
+QString takeCompleteWords(QByteArray& text, bool all);
+
+}
+
+#endif // UTF8_TEXT_H
@@ -0,0 +1,107 @@
+/*
+    Streaming reader for the metadata parts of ODF and OOXML documents
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "xmlmetadatareader.h"
+#include "extractionresult.h"
+#include "extractorplugin.h"
+
+#include <KDebug>
+
+#include <QDateTime>
+#include <QRegExp>
+#include <QStringList>
+#include <QXmlStreamReader>
+
+using namespace KFileMetaData;
+
+namespace
+{
+void addValue(const XmlMetaDataElement& element, const QString& value, ExtractionResult* result)
+{
+    if (value.isEmpty())
+        return;
+
+    switch (element.kind) {
+    case XmlMetaDataElement::Text:
+        result->add(element.property, value);
+        break;
+
+    case XmlMetaDataElement::Integer: {
+        bool ok = false;
+        const int number = value.toInt(&ok);
+        if (ok)
+            result->add(element.property, number);
+        break;
+    }
+
+    case XmlMetaDataElement::DateTime: {
+        const QDateTime dateTime = ExtractorPlugin::dateTimeFromString(value);
+        if (!dateTime.isNull())
+            result->add(element.property, dateTime);
+        break;
+    }
+
+    case XmlMetaDataElement::KeywordList:
+        foreach (const QString& keyword, value.split(QRegExp(QLatin1String("[,;]")), QString::SkipEmptyParts)) {
+            const QString trimmed = keyword.trimmed();
+            if (!trimmed.isEmpty())
+                result->add(element.property, trimmed);
+        }
+        break;
+    }
+}
+}
+
+void KFileMetaData::readXmlMetaData(const QByteArray& data, const XmlMetaDataElement* elements, int count,
+                                    ExtractionResult* result)
+{
+    QXmlStreamReader xml(data);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement())
+            continue;
+
+        // Reading the text moves the reader on, so the name and attributes are copied first
+        const QString name = xml.qualifiedName().toString();
+        const QXmlStreamAttributes attributes = xml.attributes();
+
+        QString text;
+        bool textRead = false;
+
+        for (int i = 0; i < count; i++) {
+            const XmlMetaDataElement& element = elements[i];
+            if (name != QLatin1String(element.name))
+                continue;
+
+            if (element.attribute) {
+                addValue(element, attributes.value(QLatin1String(element.attribute)).toString().trimmed(), result);
+            } else {
+                if (!textRead) {
+                    text = xml.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
+                    textRead = true;
+                }
+                addValue(element, text, result);
+            }
+        }
+    }
+
+    if (xml.hasError() && xml.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+        qWarning() << "Invalid metadata:" << xml.errorString();
+}
@@ -0,0 +1,66 @@
+/*
+    Streaming reader for the metadata parts of ODF and OOXML documents
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef XML_META_DATA_READER_H
+#define XML_META_DATA_READER_H
+
+#include "properties.h"
+
+#include <QByteArray>
+
+namespace KFileMetaData
+{
+
+class ExtractionResult;
+
+/**
+ * Describes how the value of one element of a metadata part, such as
+ * "docProps/core.xml" or "meta.xml", is turned into a property.
+ */
+struct XmlMetaDataElement {
+    enum Kind {
+        Text,
+        Integer,
+        DateTime,
+        /// A single string of keywords separated by ',' or ';'
+        KeywordList
+    };
+
+    /// The qualified name as it is written in the document, eg - "dc:title"
+    const char* name;
+
+    /// The value is read from this attribute instead of the text, if set
+    const char* attribute;
+
+    Property::Property property;
+    Kind kind;
+};
+
+/**
+ * Reads the small metadata part \p data in a single streaming pass and
+ * adds a property for every element which is listed in the \p count
+ * \p elements. Empty and invalid values are ignored.
+ */
+void readXmlMetaData(const QByteArray& data, const XmlMetaDataElement* elements, int count,
+                     ExtractionResult* result);
+
+}
+
+#endif // XML_META_DATA_READER_H
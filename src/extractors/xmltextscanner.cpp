@@ -0,0 +1,365 @@
+/*
+    Scanner for the text elements of large XML documents
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "xmltextscanner.h"
+#include "extractionresult.h"
+#include "utf8text.h"
+
+#include <QIODevice>
+#include <QStringList>
+
+#include <string.h>
+
+using namespace KFileMetaData;
+
+namespace
+{
+// Longest entity we try to decode, such as "#x10FFFF"
+const int maxEntitySize = 10;
+
+// Tags are only kept up to this size, the name is all we look at
+const int maxTagSize = 256;
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+}
+
+XmlTextScanner::XmlTextScanner()
+    : m_state(Text)
+    , m_textDepth(0)
+    , m_skipDepth(0)
+    , m_quote(0)
+    , m_emptyTag(false)
+    , m_matched(0)
+{
+}
+
+void XmlTextScanner::addTextElement(const QByteArray& name)
+{
+    m_textElements.insert(name);
+}
+
+void XmlTextScanner::addSeparator(const QByteArray& name, char separator)
+{
+    m_separators.insert(name, separator);
+}
+
+void XmlTextScanner::addSkippedElement(const QByteArray& name)
+{
+    m_skippedElements.insert(name);
+}
+
+QString XmlTextScanner::process(const char* data, int length)
+{
+    const char* const end = data + length;
+    const char* p = data;
+
+    while (p < end) {
+        switch (m_state) {
+        case Text: {
+            const char* tag = static_cast<const char*>(memchr(p, '<', end - p));
+            const char* textEnd = tag ? tag : end;
+
+            // Outside of the text elements the character data is just skipped
+            if (inText()) {
+                while (p < textEnd) {
+                    const char* amp = static_cast<const char*>(memchr(p, '&', textEnd - p));
+                    const char* spanEnd = amp ? amp : textEnd;
+                    m_text.append(p, spanEnd - p);
+                    p = spanEnd;
+
+                    if (amp) {
+                        m_entity.clear();
+                        m_state = Entity;
+                        p++;
+                        break;
+                    }
+                }
+                if (m_state == Entity)
+                    break;
+            }
+
+            p = textEnd;
+            if (tag) {
+                m_tag.clear();
+                m_emptyTag = false;
+                m_state = Tag;
+                p++;
+            }
+            break;
+        }
+
+        case Tag: {
+            // Attribute values can contain '>', so the quotes have to be tracked
+            while (p < end) {
+                const char c = *p++;
+                if (c == '>') {
+                    endTag();
+                    break;
+                } else if (c == '"' || c == '\'') {
+                    m_quote = c;
+                    m_emptyTag = false;
+                    m_state = TagQuoted;
+                    break;
+                }
+
+                // m_tag can be cut short, so "/>" is tracked on its own
+                if (!isSpace(c))
+                    m_emptyTag = (c == '/');
+
+                if (m_tag.size() < maxTagSize)
+                    m_tag.append(c);
+
+                // Comments and CDATA sections have their own end markers
+                if (m_tag.size() == 3 && m_tag == "!--") {
+                    m_matched = 0;
+                    m_state = Comment;
+                    break;
+                } else if (m_tag.size() == 8 && m_tag == "![CDATA[") {
+                    m_matched = 0;
+                    m_state = CData;
+                    break;
+                } else if (m_tag.size() == 1 && c == '?') {
+                    m_matched = 0;
+                    m_state = ProcessingInstruction;
+                    break;
+                }
+            }
+            break;
+        }
+
+        case TagQuoted: {
+            const char* quote = static_cast<const char*>(memchr(p, m_quote, end - p));
+            if (!quote) {
+                p = end;
+            } else {
+                p = quote + 1;
+                m_state = Tag;
+            }
+            break;
+        }
+
+        case Comment:
+        case ProcessingInstruction:
+            // Look for "-->" or "?>"
+            while (p < end) {
+                const char c = *p++;
+                if (c == '>' && ((m_state == Comment && m_matched >= 2) ||
+                                 (m_state == ProcessingInstruction && m_matched >= 1))) {
+                    m_state = Text;
+                    break;
+                }
+                const char marker = (m_state == Comment) ? '-' : '?';
+                m_matched = (c == marker) ? m_matched + 1 : 0;
+            }
+            break;
+
+        case CData:
+            // Look for "]]>", the data is kept as it is
+            while (p < end) {
+                const char c = *p++;
+                if (c == ']') {
+                    if (m_matched == 2) {
+                        if (inText())
+                            m_text.append(']');
+                    } else {
+                        m_matched++;
+                    }
+                } else if (c == '>' && m_matched == 2) {
+                    m_state = Text;
+                    break;
+                } else {
+                    if (inText()) {
+                        for (; m_matched > 0; m_matched--)
+                            m_text.append(']');
+                        m_text.append(c);
+                    }
+                    m_matched = 0;
+                }
+            }
+            break;
+
+        case Entity: {
+            const char c = *p;
+            if (c == ';') {
+                appendEntity();
+                m_state = Text;
+                p++;
+            } else if (c != '<' && c != '&' && !isSpace(c) && m_entity.size() < maxEntitySize) {
+                m_entity.append(c);
+                p++;
+            } else {
+                // Not an entity, keep it as it is
+                m_text.append('&');
+                m_text.append(m_entity);
+                m_state = Text;
+            }
+            break;
+        }
+        }
+    }
+
+    return takeCompleteWords(m_text, false);
+}
+
+QString XmlTextScanner::finish()
+{
+    if (m_state == Entity) {
+        m_text.append('&');
+        m_text.append(m_entity);
+    }
+
+    m_state = Text;
+    m_textDepth = 0;
+    m_skipDepth = 0;
+    m_matched = 0;
+
+    return takeCompleteWords(m_text, true);
+}
+
+void XmlTextScanner::scan(QIODevice* device, ExtractionResult* result)
+{
+    QByteArray buffer;
+    buffer.resize(64 * 1024);
+
+    qint64 size;
+    while ((size = device->read(buffer.data(), buffer.size())) > 0) {
+        const QString text = process(buffer.constData(), size);
+        if (!text.isEmpty())
+            result->append(text);
+    }
+
+    const QString text = finish();
+    if (!text.isEmpty())
+        result->append(text);
+}
+
+void XmlTextScanner::scan(const char* data, qint64 length, ExtractionResult* result)
+{
+    // The text is handed on every few pages instead of all at the end
+    const int chunkSize = 1024 * 1024;
+
+    for (qint64 offset = 0; offset < length; offset += chunkSize) {
+        const QString text = process(data + offset, qMin<qint64>(chunkSize, length - offset));
+        if (!text.isEmpty())
+            result->append(text);
+    }
+
+    const QString text = finish();
+    if (!text.isEmpty())
+        result->append(text);
+}
+
+QString XmlTextScanner::scanToString(QIODevice* device)
+{
+    QStringList texts;
+
+    QByteArray buffer;
+    buffer.resize(64 * 1024);
+
+    qint64 size;
+    while ((size = device->read(buffer.data(), buffer.size())) > 0) {
+        const QString text = process(buffer.constData(), size);
+        if (!text.isEmpty())
+            texts << text;
+    }
+
+    const QString text = finish();
+    if (!text.isEmpty())
+        texts << text;
+
+    return texts.join(QLatin1String("\n"));
+}
+
+void XmlTextScanner::endTag()
+{
+    m_state = Text;
+
+    if (m_tag.isEmpty() || m_tag.at(0) == '!')
+        return;
+
+    const bool closing = m_tag.at(0) == '/';
+    const bool empty = m_emptyTag;
+
+    // The name ends at the first whitespace or '/'
+    const int start = closing ? 1 : 0;
+    int nameEnd = start;
+    while (nameEnd < m_tag.size() && !isSpace(m_tag.at(nameEnd)) && m_tag.at(nameEnd) != '/')
+        nameEnd++;
+
+    const QByteArray name = QByteArray::fromRawData(m_tag.constData() + start, nameEnd - start);
+
+    if (!empty && m_skippedElements.contains(name)) {
+        if (closing) {
+            if (m_skipDepth > 0)
+                m_skipDepth--;
+        } else {
+            m_skipDepth++;
+        }
+        return;
+    }
+
+    if (m_skipDepth > 0)
+        return;
+
+    if (!empty && m_textElements.contains(name)) {
+        if (closing) {
+            if (m_textDepth > 0)
+                m_textDepth--;
+        } else {
+            m_textDepth++;
+        }
+    }
+
+    QHash<QByteArray, char>::const_iterator it = m_separators.constFind(name);
+    if (it == m_separators.constEnd())
+        return;
+
+    // Line breaks are also added when an element starts, for paragraphs which are
+    // nested in another one, eg - footnotes or text boxes
+    if (closing || empty || it.value() == '\n')
+        appendSeparator(it.value());
+}
+
+void XmlTextScanner::appendSeparator(char separator)
+{
+    if (m_text.isEmpty())
+        return;
+
+    // Do not pile up newlines for empty paragraphs
+    if (separator == '\n' && m_text.endsWith('\n'))
+        return;
+
+    m_text.append(separator);
+}
+
+void XmlTextScanner::appendEntity()
+{
+    uint codePoint = 0;
+    if (decodeCharacterReference(m_entity, &codePoint)) {
+        appendUtf8(m_text, codePoint);
+    } else {
+        m_text.append('&');
+        m_text.append(m_entity);
+        m_text.append(';');
+    }
+}
@@ -0,0 +1,140 @@
+/*
+    Scanner for the text elements of large XML documents
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef XML_TEXT_SCANNER_H
+#define XML_TEXT_SCANNER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+class QIODevice;
+
+namespace KFileMetaData
+{
+
+class ExtractionResult;
+
+/**
+ * \class XmlTextScanner xmltextscanner.h
+ *
+ * \brief Extracts the text of a few known elements out of a large XML
+ * document, such as the content part of an ODF or Office Open XML file.
+ *
+ * Only the character data inside the registered text elements is kept,
+ * everything else is skipped with memchr without being tokenized. The
+ * names are matched as they are written in the document, including
+ * their prefix, eg - "w:t".
+ *
+ * The document is fed in chunks of bytes which can be split anywhere.
+ */
+class XmlTextScanner
+{
+public:
+    XmlTextScanner();
+
+    /**
+     * The character data inside \p name, and all its children, is text
+     */
+    void addTextElement(const QByteArray& name);
+
+    /**
+     * Every \p name element is turned into \p separator once it ends,
+     * eg - a newline for paragraphs
+     */
+    void addSeparator(const QByteArray& name, char separator);
+
+    /**
+     * Everything inside \p name is ignored, even the text elements, eg -
+     * phonetic hints which repeat the text
+     */
+    void addSkippedElement(const QByteArray& name);
+
+    /**
+     * Processes the next \p length bytes and returns the text which is
+     * complete so far. Text is only returned up to a word boundary, the
+     * rest is returned by a later call or by finish().
+     */
+    QString process(const char* data, int length);
+
+    /**
+     * Returns the remaining text once all the data has been processed
+     */
+    QString finish();
+
+    /**
+     * Convenience function which scans all of \p device and appends the
+     * text to \p result
+     */
+    void scan(QIODevice* device, ExtractionResult* result);
+
+    /**
+     * Convenience function which scans the \p length bytes at \p data,
+     * eg - a memory mapped file, and appends the text to \p result
+     */
+    void scan(const char* data, qint64 length, ExtractionResult* result);
+
+    /**
+     * Convenience function which scans all of \p device and returns
+     * the text, with one chunk per line
+     */
+    QString scanToString(QIODevice* device);
+
+private:
+    enum State {
+        Text,
+        Tag,
+        TagQuoted,
+        Comment,
+        CData,
+        ProcessingInstruction,
+        Entity
+    };
+
+    bool inText() const
+    {
+        return m_textDepth > 0 && m_skipDepth == 0;
+    }
+
+    void endTag();
+    void appendEntity();
+    void appendSeparator(char separator);
+
+    QSet<QByteArray> m_textElements;
+    QHash<QByteArray, char> m_separators;
+    QSet<QByteArray> m_skippedElements;
+
+    State m_state;
+    int m_textDepth;
+    int m_skipDepth;
+
+    QByteArray m_text;
+    QByteArray m_tag;
+    QByteArray m_entity;
+
+    char m_quote;
+    bool m_emptyTag;
+    int m_matched;
+};
+
+}
+
+#endif // XML_TEXT_SCANNER_H
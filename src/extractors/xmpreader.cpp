@@ -0,0 +1,252 @@
+/*
+    Streaming reader for XMP metadata packets
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "xmpreader.h"
+#include "extractionresult.h"
+#include "extractorplugin.h"
+
+#include <QDateTime>
+#include <QRegExp>
+#include <QStringList>
+#include <QXmlStreamReader>
+
+using namespace KFileMetaData;
+
+namespace
+{
+const char* const rdfNamespace = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";
+const char* const xmlNamespace = "http://www.w3.org/XML/1998/namespace";
+
+enum Kind {
+    Text,
+    /// Every item of an array is a separate value
+    TextList,
+    DateTime,
+    /// A single string of keywords separated by ',' or ';'
+    KeywordList
+};
+
+struct XmpElement {
+    const char* namespaceUri;
+    const char* name;
+    Property::Property property;
+    Kind kind;
+};
+
+const XmpElement xmpElements[] = {
+    { "http://purl.org/dc/elements/1.1/", "title", Property::Title, Text },
+    { "http://purl.org/dc/elements/1.1/", "creator", Property::Author, TextList },
+    { "http://purl.org/dc/elements/1.1/", "description", Property::Description, Text },
+    { "http://purl.org/dc/elements/1.1/", "subject", Property::Keywords, TextList },
+    { "http://purl.org/dc/elements/1.1/", "language", Property::Langauge, Text },
+    { "http://ns.adobe.com/xap/1.0/", "CreateDate", Property::CreationDate, DateTime },
+    { "http://ns.adobe.com/xap/1.0/", "CreatorTool", Property::Generator, Text },
+    { "http://ns.adobe.com/pdf/1.3/", "Keywords", Property::Keywords, KeywordList },
+    { "http://ns.adobe.com/tiff/1.0/", "Make", Property::ImageMake, Text },
+    { "http://ns.adobe.com/tiff/1.0/", "Model", Property::ImageModel, Text },
+    { "http://ns.adobe.com/exif/1.0/", "DateTimeOriginal", Property::PhotoDateTimeOriginal, DateTime }
+};
+
+const int xmpElementCount = sizeof(xmpElements) / sizeof(xmpElements[0]);
+
+inline bool isList(const XmpElement& element)
+{
+    return element.kind == TextList || element.kind == KeywordList;
+}
+
+const XmpElement* findElement(const QStringRef& namespaceUri, const QStringRef& name)
+{
+    for (int i = 0; i < xmpElementCount; i++) {
+        if (name == QLatin1String(xmpElements[i].name) && namespaceUri == QLatin1String(xmpElements[i].namespaceUri))
+            return &xmpElements[i];
+    }
+    return 0;
+}
+
+/**
+ * Reads the value of the property element the reader is at, which is
+ * either plain text or an rdf:Alt, rdf:Bag or rdf:Seq array. For
+ * language alternatives only the default one is returned.
+ */
+QStringList readPropertyValues(QXmlStreamReader& xml)
+{
+    QStringList values;
+    QString text;
+    QString defaultAlternative;
+
+    int depth = 1;
+    while (depth > 0 && !xml.atEnd()) {
+        xml.readNext();
+
+        if (xml.isStartElement()) {
+            depth++;
+            if (xml.name() == QLatin1String("li") && xml.namespaceUri() == QLatin1String(rdfNamespace)) {
+                const bool isDefault = xml.attributes().value(QLatin1String(xmlNamespace), QLatin1String("lang"))
+                                       == QLatin1String("x-default");
+                const QString value = xml.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
+                depth--;
+
+                if (isDefault)
+                    defaultAlternative = value;
+                if (!value.isEmpty())
+                    values << value;
+            }
+        } else if (xml.isEndElement()) {
+            depth--;
+        } else if (xml.isCharacters() && depth == 1) {
+            text += xml.text();
+        }
+    }
+
+    if (!defaultAlternative.isEmpty())
+        return QStringList() << defaultAlternative;
+
+    if (values.isEmpty() && !text.trimmed().isEmpty())
+        values << text.trimmed();
+
+    return values;
+}
+
+QVariantList toValues(const XmpElement& element, const QStringList& strings)
+{
+    QVariantList values;
+    foreach (const QString& string, strings) {
+        switch (element.kind) {
+        case Text:
+        case TextList:
+            values << string;
+            break;
+
+        case DateTime: {
+            const QDateTime dateTime = ExtractorPlugin::dateTimeFromString(string);
+            if (!dateTime.isNull())
+                values << dateTime;
+            break;
+        }
+
+        case KeywordList:
+            foreach (const QString& keyword, string.split(QRegExp(QLatin1String("[,;]")), QString::SkipEmptyParts)) {
+                const QString trimmed = keyword.trimmed();
+                if (!trimmed.isEmpty())
+                    values << trimmed;
+            }
+            break;
+        }
+
+        // Only list properties have several values
+        if (!isList(element) && !values.isEmpty())
+            break;
+    }
+
+    return values;
+}
+}
+
+XmpReader::XmpReader()
+{
+}
+
+XmpReader::XmpReader(const QByteArray& packet)
+{
+    if (packet.isEmpty())
+        return;
+
+    QXmlStreamReader xml(packet);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement())
+            continue;
+
+        // Simple properties can also be written as attributes of rdf:Description
+        if (xml.name() == QLatin1String("Description") && xml.namespaceUri() == QLatin1String(rdfNamespace)) {
+            foreach (const QXmlStreamAttribute& attribute, xml.attributes()) {
+                const XmpElement* element = findElement(attribute.namespaceUri(), attribute.name());
+                const QString value = attribute.value().toString().trimmed();
+                if (!element || value.isEmpty() || (!isList(*element) && contains(element->property)))
+                    continue;
+
+                foreach (const QVariant& variant, toValues(*element, QStringList() << value))
+                    addValue(element->property, variant);
+            }
+            continue;
+        }
+
+        const XmpElement* element = findElement(xml.namespaceUri(), xml.name());
+        if (!element)
+            continue;
+
+        // A packet can have several rdf:Description elements, the first one wins
+        if (!isList(*element) && contains(element->property))
+            continue;
+
+        // This moves the reader to the end of the property element
+        foreach (const QVariant& variant, toValues(*element, readPropertyValues(xml)))
+            addValue(element->property, variant);
+    }
+}
+
+void XmpReader::addValues(const QString& namespaceUri, const QString& name, const QStringList& values)
+{
+    const XmpElement* element = findElement(QStringRef(&namespaceUri), QStringRef(&name));
+    if (!element || (!isList(*element) && contains(element->property)))
+        return;
+
+    foreach (const QVariant& variant, toValues(*element, values))
+        addValue(element->property, variant);
+}
+
+bool XmpReader::isEmpty() const
+{
+    return m_properties.isEmpty();
+}
+
+bool XmpReader::contains(Property::Property property) const
+{
+    return m_values.contains(property);
+}
+
+QList<Property::Property> XmpReader::properties() const
+{
+    return m_properties;
+}
+
+QVariantList XmpReader::values(Property::Property property) const
+{
+    return m_values.value(property);
+}
+
+void XmpReader::addProperties(ExtractionResult* result) const
+{
+    foreach (Property::Property property, m_properties) {
+        foreach (const QVariant& value, m_values.value(property))
+            result->add(property, value);
+    }
+}
+
+void XmpReader::addValue(Property::Property property, const QVariant& value)
+{
+    QHash<int, QVariantList>::iterator it = m_values.find(property);
+    if (it == m_values.end()) {
+        m_properties << property;
+        m_values.insert(property, QVariantList() << value);
+    } else if (!it.value().contains(value)) {
+        it.value() << value;
+    }
+}
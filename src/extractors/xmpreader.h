@@ -0,0 +1,95 @@
+/*
+    Streaming reader for XMP metadata packets
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef XMP_READER_H
+#define XMP_READER_H
+
+#include "properties.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QVariant>
+
+namespace KFileMetaData
+{
+
+class ExtractionResult;
+
+/**
+ * \class XmpReader xmpreader.h
+ *
+ * \brief Reads the properties of an XMP metadata packet, such as the
+ * metadata stream of a PDF or the XMP segment of an image.
+ *
+ * The packet is parsed in a single streaming pass. XMP which has already
+ * been decoded by another library can be passed in with addValues()
+ * instead, it is mapped in the same way. Only the Dublin Core
+ * title, creators, description, subjects and language, the creation
+ * date, creator tool and PDF keywords, and the camera make, model and
+ * original date of photos are read.
+ *
+ * XMP values are properly encoded and often more complete, so they take
+ * precedence: if a file also has older metadata for the same property,
+ * such as the Info dictionary of a PDF or the Exif data of an image,
+ * the callers only use that when contains() is false for the property.
+ */
+class XmpReader
+{
+public:
+    /**
+     * Creates an empty reader, the values are then passed with addValues()
+     */
+    XmpReader();
+    explicit XmpReader(const QByteArray& packet);
+
+    /**
+     * Adds the \p values of the XMP property \p name in \p namespaceUri.
+     * A language alternative only has the value of its default language.
+     * Properties which are not read are ignored.
+     */
+    void addValues(const QString& namespaceUri, const QString& name, const QStringList& values);
+
+    bool isEmpty() const;
+    bool contains(Property::Property property) const;
+
+    /**
+     * The properties which were found, in the order of the packet
+     */
+    QList<Property::Property> properties() const;
+
+    QVariantList values(Property::Property property) const;
+
+    /**
+     * Adds all the values of the packet to \p result
+     */
+    void addProperties(ExtractionResult* result) const;
+
+private:
+    void addValue(Property::Property property, const QVariant& value);
+
+    QList<Property::Property> m_properties;
+    QHash<int, QVariantList> m_values;
+};
+
+}
+
+#endif // XMP_READER_H
@@ -0,0 +1,322 @@
+/*
+    Read only access to the entries of a ZIP file
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "zipcontainer.h"
+
+#include <QIODevice>
+#include <QtEndian>
+
+#include <string.h>
+#include <zlib.h>
+
+using namespace KFileMetaData;
+
+namespace
+{
+const quint32 localHeaderSignature = 0x04034b50;
+const quint32 centralHeaderSignature = 0x02014b50;
+const quint32 endOfCentralDirectorySignature = 0x06054b50;
+
+const int localHeaderSize = 30;
+const int centralHeaderSize = 46;
+const int endOfCentralDirectorySize = 22;
+
+// Entries larger than this are not read at all
+const quint32 maxEntrySize = 1024 * 1024 * 1024;
+
+// XML compresses well, but not more than this. Only checked for entries above 1 MiB.
+const quint32 maxCompressionRatio = 1000;
+
+inline quint16 readUInt16(const uchar* data)
+{
+    return qFromLittleEndian<quint16>(data);
+}
+
+inline quint32 readUInt32(const uchar* data)
+{
+    return qFromLittleEndian<quint32>(data);
+}
+
+/**
+ * Reads a stored or deflated entry straight out of the mapped file.
+ * Data is only inflated when it is read.
+ */
+class ZipEntryDevice : public QIODevice
+{
+public:
+    ZipEntryDevice(const uchar* data, quint32 compressedSize, quint32 uncompressedSize, bool deflated)
+        : m_data(data)
+        , m_compressedSize(compressedSize)
+        , m_uncompressedSize(uncompressedSize)
+        , m_position(0)
+        , m_deflated(deflated)
+        , m_streamInitialized(false)
+    {
+        memset(&m_stream, 0, sizeof(m_stream));
+    }
+
+    virtual ~ZipEntryDevice()
+    {
+        if (m_streamInitialized)
+            inflateEnd(&m_stream);
+    }
+
+    bool init()
+    {
+        if (m_deflated) {
+            m_stream.next_in = const_cast<Bytef*>(m_data);
+            m_stream.avail_in = m_compressedSize;
+
+            // Raw deflate data, without a zlib header
+            if (inflateInit2(&m_stream, -MAX_WBITS) != Z_OK)
+                return false;
+            m_streamInitialized = true;
+        }
+
+        // The data is inflated straight into the buffer of the caller
+        return open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    virtual bool isSequential() const
+    {
+        return true;
+    }
+
+    virtual qint64 size() const
+    {
+        return m_uncompressedSize;
+    }
+
+    virtual qint64 bytesAvailable() const
+    {
+        return (m_uncompressedSize - m_position) + QIODevice::bytesAvailable();
+    }
+
+protected:
+    virtual qint64 readData(char* data, qint64 maxSize)
+    {
+        // Never return more than the entry claims to contain
+        maxSize = qMin<qint64>(maxSize, m_uncompressedSize - m_position);
+        if (maxSize <= 0)
+            return -1;
+
+        if (!m_deflated) {
+            memcpy(data, m_data + m_position, maxSize);
+            m_position += maxSize;
+            return maxSize;
+        }
+
+        m_stream.next_out = reinterpret_cast<Bytef*>(data);
+        m_stream.avail_out = maxSize;
+
+        const int ret = inflate(&m_stream, Z_NO_FLUSH);
+        const qint64 size = maxSize - m_stream.avail_out;
+        m_position += size;
+
+        if (ret != Z_OK && ret != Z_STREAM_END) {
+            setErrorString(QLatin1String("Corrupt deflate data"));
+            m_position = m_uncompressedSize;
+        } else if (ret == Z_STREAM_END) {
+            m_position = m_uncompressedSize;
+        }
+
+        return size > 0 ? size : -1;
+    }
+
+    virtual qint64 writeData(const char*, qint64)
+    {
+        return -1;
+    }
+
+private:
+    const uchar* m_data;
+    quint32 m_compressedSize;
+    quint32 m_uncompressedSize;
+    quint32 m_position;
+    bool m_deflated;
+
+    z_stream m_stream;
+    bool m_streamInitialized;
+};
+}
+
+ZipContainer::ZipContainer(const QString& fileName, bool allowMapping)
+    : m_file(fileName, allowMapping)
+    , m_data(m_file.data())
+    , m_size(m_file.size())
+{
+    if (m_size < endOfCentralDirectorySize)
+        return;
+
+    if (!readCentralDirectory())
+        m_entries.clear();
+}
+
+ZipContainer::~ZipContainer()
+{
+}
+
+bool ZipContainer::isValid() const
+{
+    return !m_entries.isEmpty();
+}
+
+QStringList ZipContainer::entries() const
+{
+    return m_names;
+}
+
+bool ZipContainer::contains(const QString& name) const
+{
+    return m_entries.contains(name);
+}
+
+bool ZipContainer::readCentralDirectory()
+{
+    // The end of central directory record is followed by a comment of up to 64 KiB
+    qint64 end = m_size - endOfCentralDirectorySize;
+    const qint64 searchStart = qMax<qint64>(0, end - 0xFFFF);
+    while (end >= searchStart && readUInt32(m_data + end) != endOfCentralDirectorySignature)
+        end--;
+
+    if (end < searchStart)
+        return false;
+
+    const quint16 count = readUInt16(m_data + end + 10);
+    const quint32 directorySize = readUInt32(m_data + end + 12);
+    const quint32 directoryOffset = readUInt32(m_data + end + 16);
+    if (qint64(directoryOffset) + directorySize > end)
+        return false;
+
+    m_entries.reserve(count);
+
+    qint64 position = directoryOffset;
+    const qint64 directoryEnd = qint64(directoryOffset) + directorySize;
+    for (int i = 0; i < count; i++) {
+        if (position + centralHeaderSize > directoryEnd)
+            return false;
+
+        const uchar* header = m_data + position;
+        if (readUInt32(header) != centralHeaderSignature)
+            return false;
+
+        const quint16 nameLength = readUInt16(header + 28);
+        const quint16 extraLength = readUInt16(header + 30);
+        const quint16 commentLength = readUInt16(header + 32);
+
+        const qint64 next = position + centralHeaderSize + nameLength + extraLength + commentLength;
+        if (next > directoryEnd)
+            return false;
+
+        Entry entry;
+        entry.flags = readUInt16(header + 8);
+        entry.method = readUInt16(header + 10);
+        entry.compressedSize = readUInt32(header + 20);
+        entry.uncompressedSize = readUInt32(header + 24);
+        entry.localHeaderOffset = readUInt32(header + 42);
+
+        // Names are either UTF-8 or, in old archivers, in the DOS code page
+        const char* rawName = reinterpret_cast<const char*>(header + centralHeaderSize);
+        const QString name = (entry.flags & 0x0800) ? QString::fromUtf8(rawName, nameLength)
+                                                     : QString::fromLatin1(rawName, nameLength);
+
+        position = next;
+
+        // Directories and ZIP64 entries, which documents never need
+        if (name.isEmpty() || name.endsWith(QLatin1Char('/')) ||
+                entry.compressedSize == 0xFFFFFFFF || entry.uncompressedSize == 0xFFFFFFFF)
+            continue;
+
+        if (!m_entries.contains(name))
+            m_names << name;
+        m_entries.insert(name, entry);
+    }
+
+    return true;
+}
+
+QIODevice* ZipContainer::device(const QString& name)
+{
+    QHash<QString, Entry>::const_iterator it = m_entries.constFind(name);
+    if (it == m_entries.constEnd())
+        return 0;
+
+    const Entry& entry = it.value();
+
+    // Encrypted, or compressed with something other than deflate
+    if ((entry.flags & 0x0001) || (entry.method != 0 && entry.method != 8))
+        return 0;
+
+    if (entry.uncompressedSize > maxEntrySize)
+        return 0;
+
+    if (entry.uncompressedSize > 1024 * 1024 &&
+            entry.uncompressedSize / qMax<quint32>(entry.compressedSize, 1) > maxCompressionRatio)
+        return 0;
+
+    const qint64 headerOffset = entry.localHeaderOffset;
+    if (headerOffset + localHeaderSize > m_size)
+        return 0;
+
+    const uchar* header = m_data + headerOffset;
+    if (readUInt32(header) != localHeaderSignature)
+        return 0;
+
+    // The local header can have a different extra field than the central one
+    const qint64 dataOffset = headerOffset + localHeaderSize + readUInt16(header + 26) + readUInt16(header + 28);
+    if (dataOffset + entry.compressedSize > m_size)
+        return 0;
+
+    // Stored entries have to contain as much data as they claim
+    if (entry.method == 0 && entry.compressedSize < entry.uncompressedSize)
+        return 0;
+
+    ZipEntryDevice* device = new ZipEntryDevice(m_data + dataOffset, entry.compressedSize,
+                                                entry.uncompressedSize, entry.method == 8);
+    if (!device->init()) {
+        delete device;
+        return 0;
+    }
+
+    return device;
+}
+
+QByteArray ZipContainer::data(const QString& name, qint64 maxSize)
+{
+    QIODevice* device = this->device(name);
+    if (!device)
+        return QByteArray();
+
+    QByteArray data;
+    data.resize(qMin(device->size(), maxSize));
+
+    qint64 size = 0;
+    while (size < data.size()) {
+        const qint64 n = device->read(data.data() + size, data.size() - size);
+        if (n <= 0)
+            break;
+        size += n;
+    }
+
+    data.resize(size);
+    delete device;
+
+    return data;
+}
@@ -0,0 +1,111 @@
+/*
+    Read only access to the entries of a ZIP file
+    Copyright (C) 2026  The KFileMetaData developers <kde-devel@kde.org>
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef ZIP_CONTAINER_H
+#define ZIP_CONTAINER_H
+
+#include "mappedfile.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+namespace KFileMetaData
+{
+
+/**
+ * \class ZipContainer zipcontainer.h
+ *
+ * \brief Read only access to the entries of a ZIP file, the container
+ * used by ODF, Office Open XML and EPub documents.
+ *
+ * The file is memory mapped and only its central directory is parsed
+ * when it is opened. Entries are inflated while they are being read,
+ * so reading the beginning of a large entry does not inflate all of it.
+ *
+ * To protect against zip bombs, entries which claim to be much larger
+ * than their compressed data are not read, and entries are cut short
+ * if they inflate to more than they claim.
+ */
+class ZipContainer
+{
+public:
+    /**
+     * Opens the ZIP file \p fileName. With \p allowMapping set to false
+     * the file is read into memory instead of being mapped.
+     */
+    explicit ZipContainer(const QString& fileName, bool allowMapping = true);
+    ~ZipContainer();
+
+    /**
+     * Returns true if the file is a ZIP file which could be indexed
+     */
+    bool isValid() const;
+
+    /**
+     * The full paths of all the entries, in the order in which they are
+     * stored in the file. Directories are not listed.
+     */
+    QStringList entries() const;
+
+    bool contains(const QString& name) const;
+
+    /**
+     * Returns a device which reads the uncompressed data of the entry
+     * \p name, or 0 if there is no such entry or it cannot be read.
+     * The caller takes ownership of the device, which must not be used
+     * after the ZipContainer has been destroyed.
+     *
+     * The container is not modified, so devices for different entries
+     * can be created and read in different threads at the same time.
+     */
+    QIODevice* device(const QString& name);
+
+    /**
+     * Reads at most \p maxSize bytes of the uncompressed data of the
+     * entry \p name.
+     */
+    QByteArray data(const QString& name, qint64 maxSize = 16 * 1024 * 1024);
+
+private:
+    struct Entry {
+        quint16 flags;
+        quint16 method;
+        quint32 compressedSize;
+        quint32 uncompressedSize;
+        quint32 localHeaderOffset;
+    };
+
+    bool readCentralDirectory();
+
+    MappedFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+
+    QStringList m_names;
+    QHash<QString, Entry> m_entries;
+};
+
+}
+
+#endif // ZIP_CONTAINER_H
@@ -92,7 +92,11 @@ enum Property {
     PhotoSaturation,
     PhotoSharpness,
 
-    LastProperty = PhotoSharpness
+    // Documents
+    SheetCount,
+    SlideCount,
+
+    LastProperty = SlideCount
 };
 
 } // namespace Property
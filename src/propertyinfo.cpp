@@ -333,6 +333,18 @@ PropertyInfo::PropertyInfo(Property::Property property)
             d->valueType = QVariant::Int;
             break;
 
+        case Property::SheetCount:
+            d->name = QLatin1String("sheetCount");
+            d->displayName = i18nc("@label number of sheets in a spreadsheet", "Sheet Count");
+            d->valueType = QVariant::Int;
+            break;
+
+        case Property::SlideCount:
+            d->name = QLatin1String("slideCount");
+            d->displayName = i18nc("@label number of slides in a presentation", "Slide Count");
+            d->valueType = QVariant::Int;
+            break;
+
         case Property::Subject:
             d->name = QLatin1String("subject");
             d->displayName = i18nc("@label", "Subject");
@@ -466,6 +478,8 @@ PropertyInfo PropertyInfo::fromName(const QString& name)
         propertyHash.insert(QLatin1String("photoisospeedratings"), Property::PhotoISOSpeedRatings);
         propertyHash.insert(QLatin1String("photosaturation"), Property::PhotoSaturation);
         propertyHash.insert(QLatin1String("photosharpness"), Property::PhotoSharpness);
+        propertyHash.insert(QLatin1String("sheetcount"), Property::SheetCount);
+        propertyHash.insert(QLatin1String("slidecount"), Property::SlideCount);
     }
 
     return PropertyInfo(propertyHash.value(name.toLower()));